@@ -25,11 +25,18 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #version 120
 
 varying float depthfrag;
+varying vec2 kinectCoordfrag;
 
 uniform sampler2DRect heightColorMapSampler;
 uniform sampler2DRect pixelCornerElevationSampler; // Sampler for the half pixel texture
 uniform float contourLineFactor;
 uniform int drawContourLines;
+uniform sampler2DRect fireStateSampler; // Sampler for the state of the fire cells, one byte per cell
+uniform vec4 fireGrid; // Depth image-space coordinate of the first fire cell (x, y) and pixels per cell (z)
+uniform vec2 fireGridSize; // Number of fire cells per row and per column
+uniform vec4 burningColor;
+uniform vec4 extinguishedColor;
+uniform int drawFire;
 
 void main()
 {
@@ -77,5 +84,19 @@ void main()
         }
     }
 
+    if (drawFire == 1)
+    {
+        /* Blend the color of the fire cell containing the pixel (a vertex is half a pixel before its depth pixel): */
+        vec2 cell = floor((kinectCoordfrag + 0.5 - fireGrid.xy) / fireGrid.z);
+        if (all(greaterThanEqual(cell, vec2(0.0))) && all(lessThan(cell, fireGridSize)))
+        {
+            float state = floor(texture2DRect(fireStateSampler, cell + 0.5).r * 255.0 + 0.5);
+            if (state == 1.0)
+                color.rgb = mix(color.rgb, burningColor.rgb, burningColor.a);
+            else if (state == 2.0)
+                color.rgb = mix(color.rgb, extinguishedColor.rgb, extinguishedColor.a);
+        }
+    }
+
     gl_FragColor = color;
 }
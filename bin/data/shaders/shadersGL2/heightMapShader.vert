@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #version 120
 
 varying float depthfrag;
+varying vec2 kinectCoordfrag;
 
 uniform sampler2DRect tex0; // Sampler for the depth image-space elevation texture automatically set by binding
 
@@ -58,6 +59,9 @@ void main()
     float elevation = dot(basePlaneEq,vertexCcx);///vertexCc.w;
     depthfrag = elevation*heightColorMapTransformation.x+heightColorMapTransformation.y;
     
+    /* Depth image-space coordinate of the vertex, to find its fire cell: */
+    kinectCoordfrag = texcoord;
+    
     /* Transform vertex to proj coordinates: */
     vec4 screenPos = kinectProjMatrix * vertexCcx;
     vec4 projectedPoint = screenPos / screenPos.z;
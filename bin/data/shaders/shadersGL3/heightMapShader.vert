@@ -39,6 +39,7 @@ in vec2 texcoord;
 
 // this is something send to the fragment shader
 out float depthfrag;
+out vec2 kinectCoordfrag;
 
 uniform sampler2DRect tex0; // Sampler for the depth image-space elevation texture automatically set by binding
 
@@ -71,6 +72,9 @@ void main()
     float elevation = dot(basePlaneEq,vertexCcx);///vertexCc.w;
     depthfrag = elevation*heightColorMapTransformation.x+heightColorMapTransformation.y;
     
+    /* Depth image-space coordinate of the vertex, to find its fire cell: */
+    kinectCoordfrag = texcoord;
+    
     /* Transform vertex to proj coordinates: */
     vec4 screenPos = kinectProjMatrix * vertexCcx;
     vec4 projectedPoint = screenPos / screenPos.z;
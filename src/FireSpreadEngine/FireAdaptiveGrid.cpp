@@ -0,0 +1,122 @@
+/***********************************************************************
+FireAdaptiveGrid - two level grid over the cells of FireSpreadEngine.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireAdaptiveGrid.h"
+
+#include <algorithm>
+#include <iterator>
+
+FireAdaptiveGrid::FireAdaptiveGrid()
+:cols(0),
+rows(0),
+blockSize(16),
+blockCols(0),
+blockRows(0)
+{
+}
+
+void FireAdaptiveGrid::setup(int scols, int srows, int sblockSize) {
+	cols = scols;
+	rows = srows;
+	blockSize = std::max(sblockSize, 1);
+	blockCols = (cols + blockSize - 1) / blockSize;
+	blockRows = (rows + blockSize - 1) / blockSize;
+	clear();
+}
+
+void FireAdaptiveGrid::clear() {
+	levels.assign(blockCols * blockRows, COARSE_UNBURNT);
+	burning.assign(levels.size(), 0);
+	burnt.assign(levels.size(), 0);
+	refinedBlocks.clear();
+	newlyRefinedBlocks.clear();
+}
+
+bool FireAdaptiveGrid::update(const FireSpreadEngine& engine) {
+	if (engine.getCols() != cols || engine.getRows() != rows)
+		setup(engine.getCols(), engine.getRows(), blockSize);
+
+	// blocks with burning and with extinguished cells, one word of the bit planes at a time
+	const FireStateRaster& state = engine.getStateRaster();
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	std::fill(burning.begin(), burning.end(), 0);
+	std::fill(burnt.begin(), burnt.end(), 0);
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		markBlocks(w, low[w] & ~high[w], burning);
+		markBlocks(w, high[w] & ~low[w], burnt);
+	}
+
+	// the blocks around a burning block are refined before the fire reaches them
+	std::vector<int>& previous = previousRefinedBlocks;
+	previous.swap(refinedBlocks);
+	refinedBlocks.clear();
+	for (size_t block = 0; block < levels.size(); block++)
+		levels[block] = static_cast<unsigned char>(burnt[block] ? COARSE_BURNT : COARSE_UNBURNT);
+	for (int blockY = 0; blockY < blockRows; blockY++) {
+		for (int blockX = 0; blockX < blockCols; blockX++) {
+			if (!burning[blockY * blockCols + blockX])
+				continue;
+			for (int y = std::max(blockY - 1, 0); y <= std::min(blockY + 1, blockRows - 1); y++) {
+				for (int x = std::max(blockX - 1, 0); x <= std::min(blockX + 1, blockCols - 1); x++)
+					levels[y * blockCols + x] = REFINED;
+			}
+		}
+	}
+	for (size_t block = 0; block < levels.size(); block++) {
+		if (levels[block] == REFINED)
+			refinedBlocks.push_back(static_cast<int>(block));
+	}
+
+	// both lists are sorted
+	newlyRefinedBlocks.clear();
+	std::set_difference(refinedBlocks.begin(), refinedBlocks.end(), previous.begin(), previous.end(), std::back_inserter(newlyRefinedBlocks));
+	return !newlyRefinedBlocks.empty() || refinedBlocks.size() != previous.size();
+}
+
+// Marks the blocks of the cells of a word, one run of cells of the same block and row at a time
+void FireAdaptiveGrid::markBlocks(int w, uint64_t bits, std::vector<unsigned char>& blocks) {
+	while (bits) {
+		int index = 64 * w + FireStateRaster::lowestBit(bits);
+		int x = index % cols;
+		int y = index / cols;
+		blocks[(y / blockSize) * blockCols + x / blockSize] = 1;
+		// end of the run: end of the block or of the row
+		int end = y * cols + std::min((x / blockSize + 1) * blockSize, cols) - 64 * w;
+		bits = end >= 64 ? 0 : bits & ~((static_cast<uint64_t>(1) << end) - 1);
+	}
+}
+
+void FireAdaptiveGrid::getBlockArea(int block, int& x, int& y, int& width, int& height) const {
+	x = (block % blockCols) * blockSize;
+	y = (block / blockCols) * blockSize;
+	width = std::min(blockSize, cols - x);
+	height = std::min(blockSize, rows - y);
+}
+
+int FireAdaptiveGrid::getNumberOfRefinedCells() const {
+	int cells = 0;
+	for (int block : refinedBlocks) {
+		int x, y, width, height;
+		getBlockArea(block, x, y, width, height);
+		cells += width * height;
+	}
+	return cells;
+}
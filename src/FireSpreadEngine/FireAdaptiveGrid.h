@@ -0,0 +1,95 @@
+/***********************************************************************
+FireAdaptiveGrid - two level grid over the cells of FireSpreadEngine:
+square blocks of cells are refined while the fire burns in them or in
+one of the blocks around them, and coarse otherwise (unburnt, or burnt
+after the front has passed). The terrain only needs to be sampled at
+the resolution of the cells in the refined blocks, where the fire can
+spread before the next update: the cost of a depth frame follows the
+front instead of the whole sandbox.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "FireSpreadEngine.h"
+
+class FireAdaptiveGrid {
+public:
+	enum BlockLevel {
+		COARSE_UNBURNT = 0,	// no burnt cell, no fire around
+		REFINED = 1,		// burning cells in the block or in one of the eight blocks around it
+		COARSE_BURNT = 2	// burnt cells, the fire went out in the block and around it
+	};
+
+	FireAdaptiveGrid();
+
+	// Blocks of blockSize x blockSize cells over a raster, every block is coarse and unburnt
+	void setup(int cols, int rows, int blockSize = 16);
+	void clear();
+
+	/***
+	Levels of the blocks from the state raster of the engine (so clearFire(), reset() and restoreState() are followed
+	as well), the whole raster is set up again when its size changes. The fire spreads by one cell per time step at
+	most: called after every time step, a cell can only catch fire in a refined block.
+	Returns false if no block was refined or coarsened.
+	***/
+	bool update(const FireSpreadEngine& engine);
+
+	int getBlockSize() const {
+		return blockSize;
+	}
+	int getBlockCols() const {
+		return blockCols;
+	}
+	int getBlockRows() const {
+		return blockRows;
+	}
+	int getNumberOfBlocks() const {
+		return blockCols * blockRows;
+	}
+	BlockLevel getLevel(int block) const {
+		return static_cast<BlockLevel>(levels[block]);
+	}
+	// Cells of a block (x, y, width, height), the blocks of the last row and column may be smaller
+	void getBlockArea(int block, int& x, int& y, int& width, int& height) const;
+
+	// Refined blocks, sorted
+	const std::vector<int>& getRefinedBlocks() const {
+		return refinedBlocks;
+	}
+	// Blocks refined by the last update, sorted: their terrain is only sampled from now on
+	const std::vector<int>& getNewlyRefinedBlocks() const {
+		return newlyRefinedBlocks;
+	}
+	int getNumberOfRefinedCells() const;
+
+private:
+	void markBlocks(int w, uint64_t bits, std::vector<unsigned char>& blocks);
+
+	int cols, rows;
+	int blockSize;
+	int blockCols, blockRows;
+	std::vector<unsigned char> levels;		// BlockLevel of every block
+	std::vector<unsigned char> burning;		// blocks with burning cells
+	std::vector<unsigned char> burnt;		// blocks with extinguished cells
+	std::vector<int> refinedBlocks;
+	std::vector<int> previousRefinedBlocks;
+	std::vector<int> newlyRefinedBlocks;
+};
@@ -0,0 +1,240 @@
+/***********************************************************************
+FireArrivalTime - deterministic version of the fire spread model.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireArrivalTime.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+static const float infiniteTime = std::numeric_limits<float>::infinity();
+
+enum CellFlag {
+	cellAccepted = 1,	// the arrival time of the cell is final
+	cellBlocked = 2		// water, protected or non burnable, the fire never reaches the cell
+};
+
+FireArrivalTime::FireArrivalTime()
+:cols(0),
+rows(0),
+neighbours(4),
+terrain(0)
+{
+}
+
+/***
+The fire needs spreadDelay(p) time steps to cross a cell towards a neighbour, where p comes from the wind,
+slope and vegetation effects of the stochastic model. The number of time steps before a spread with the
+probability p at every time step follows a geometric distribution; only the spreads before the burning
+cell is extinguished (burnDuration time steps) count, so the delay is the median of the distribution
+truncated to burnDuration:
+	(1 - p)^delay = 1 - (1 - (1 - p)^burnDuration) / 2
+The median is used rather than the mean: a cell catches fire from the first of the neighbours that spread
+to it, so the stochastic front moves faster than one mean delay per cell (about as fast as the median).
+***/
+float FireArrivalTime::spreadDelay(float probability, int burnDuration) {
+	if (probability >= 1)
+		return 1;
+	double missed = std::pow(1.0 - probability, static_cast<double>(burnDuration));
+	// a new fire spreads at the next time step at the earliest
+	return std::max(static_cast<float>(std::log(1.0 - (1.0 - missed) / 2) / std::log(1.0 - probability)), 1.0f);
+}
+
+/***
+Fast marching: the cells are accepted by increasing arrival time, from a heap of tentative times, and the
+tentative times of the neighbours of every accepted cell are updated with the upwind scheme of updateCell().
+Every cell is accepted once: O(n log n) for n cells.
+***/
+bool FireArrivalTime::solve(const FireSpreadEngine& engine, int x, int y) {
+	cols = engine.getCols();
+	rows = engine.getRows();
+	terrain = &engine.getTerrain();
+	neighbours = engine.getNumberOfNeighbours();
+	int cells = cols * rows;
+	arrivalTimes.assign(cells, infiniteTime);
+	cellFlags.assign(cells, 0);
+	burnDurations.resize(cells);
+	reachedCells.clear();
+	reachedCells.reserve(cells);
+
+	for (int source = 0; source < FireSpreadEngine::numberOfFuelModels; source++) {
+		int duration = FireSpreadEngine::getBurnDuration(static_cast<FireSpreadEngine::VegetationType>(source));
+		for (int model = 0; model < FireSpreadEngine::numberOfFuelModels; model++) {
+			for (int n = 0; n < neighbours; n++) {
+				for (int band = 0; band < FireTerrain::numberOfSlopeBands; band++) {
+					float probability = engine.getSpreadProbability(static_cast<FireSpreadEngine::VegetationType>(model), n, band);
+					delays[source][model][n][band] = spreadDelay(std::min(probability / 100, 1.0f), duration);
+				}
+			}
+		}
+	}
+	for (int index = 0; index < cells; index++) {
+		burnDurations[index] = static_cast<unsigned char>(FireSpreadEngine::getBurnDuration(
+			static_cast<FireSpreadEngine::VegetationType>(terrain->getFuelModel(index))));
+		if (terrain->isWater(index) || burnDurations[index] == 0 || engine.getCellState(index) == FireSpreadEngine::PROTECTED)
+			cellFlags[index] = cellBlocked;
+	}
+
+	if (!engine.isInside(x, y) || cellFlags[y * cols + x] == cellBlocked)
+		return false;
+
+	heap.clear();
+	arrivalTimes[y * cols + x] = 0;
+	heap.push_back(std::make_pair(0.0f, y * cols + x));
+	while (!heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<float, int> >());
+		int index = heap.back().second;
+		heap.pop_back();
+		// a cell is pushed again when its time decreases, only its first pop counts
+		if (cellFlags[index] & cellAccepted)
+			continue;
+		cellFlags[index] |= cellAccepted;
+		reachedCells.push_back(index);
+
+		int cellX = index % cols;
+		int cellY = index / cols;
+		float time = arrivalTimes[index];
+		if (cellX > 0 && cellFlags[index - 1] == 0)
+			updateCell(index - 1, time);
+		if (cellX < cols - 1 && cellFlags[index + 1] == 0)
+			updateCell(index + 1, time);
+		if (cellY > 0 && cellFlags[index - cols] == 0)
+			updateCell(index - cols, time);
+		if (cellY < rows - 1 && cellFlags[index + cols] == 0)
+			updateCell(index + cols, time);
+		for (int n = 4; n < neighbours; n++) {
+			int newX = cellX + FireTerrain::offsetX(n);
+			int newY = cellY + FireTerrain::offsetY(n);
+			if (engine.isInside(newX, newY) && cellFlags[newY * cols + newX] == 0)
+				updateCell(newY * cols + newX, time);
+		}
+	}
+	terrain = 0;
+	return true;
+}
+
+/***
+Tentative arrival time of a cell from its accepted neighbours. In each direction (horizontal, vertical) the
+upwind neighbour is the one from which the fire arrives first; with arrival times tx, ty and delays ax, ay
+from the upwind neighbours, the arrival time t is the solution of
+	((t - tx) / ax)^2 + ((t - ty) / ay)^2 = 1
+so that a fire coming from two directions is faster than along each of them, as on a continuous surface.
+When there is only one upwind neighbour, or the fires from the two directions are too far apart, t is
+the earliest of tx + ax and ty + ay. With eight neighbours, the fire coming from an accepted diagonal neighbour
+d is one more candidate td + ad. The time is never before acceptedTime (the time of the cell that was
+just accepted), so that reachedCells is sorted.
+***/
+void FireArrivalTime::updateCell(int index, float acceptedTime) {
+	int cellX = index % cols;
+	int cellY = index / cols;
+	const unsigned char* fuelModels = terrain->getFuelModels();
+	int model = fuelModels[index];
+
+	float tx = infiniteTime, ax = 0;
+	if (cellX > 0 && (cellFlags[index - 1] & cellAccepted)) {
+		float delay = delays[fuelModels[index - 1]][model][FireTerrain::RIGHT][terrain->getSlopeBand(FireTerrain::RIGHT, index - 1)];
+		tx = arrivalTimes[index - 1];
+		ax = delay;
+	}
+	if (cellX < cols - 1 && (cellFlags[index + 1] & cellAccepted)) {
+		float delay = delays[fuelModels[index + 1]][model][FireTerrain::LEFT][terrain->getSlopeBand(FireTerrain::LEFT, index + 1)];
+		if (arrivalTimes[index + 1] + delay < tx + ax) {
+			tx = arrivalTimes[index + 1];
+			ax = delay;
+		}
+	}
+	float ty = infiniteTime, ay = 0;
+	if (cellY > 0 && (cellFlags[index - cols] & cellAccepted)) {
+		float delay = delays[fuelModels[index - cols]][model][FireTerrain::DOWN][terrain->getSlopeBand(FireTerrain::DOWN, index - cols)];
+		ty = arrivalTimes[index - cols];
+		ay = delay;
+	}
+	if (cellY < rows - 1 && (cellFlags[index + cols] & cellAccepted)) {
+		float delay = delays[fuelModels[index + cols]][model][FireTerrain::UP][terrain->getSlopeBand(FireTerrain::UP, index + cols)];
+		if (arrivalTimes[index + cols] + delay < ty + ay) {
+			ty = arrivalTimes[index + cols];
+			ay = delay;
+		}
+	}
+
+	float time = std::min(tx + ax, ty + ay);
+	if (tx != infiniteTime && ty != infiniteTime) {
+		float a = 1 / (ax * ax);
+		float b = 1 / (ay * ay);
+		float discriminant = a + b - a * b * (tx - ty) * (tx - ty);
+		if (discriminant >= 0) {
+			float t = (a * tx + b * ty + std::sqrt(discriminant)) / (a + b);
+			if (t >= std::max(tx, ty))
+				time = std::min(time, t);
+		}
+	}
+
+	for (int n = 4; n < neighbours; n++) {
+		// n: direction from the diagonal neighbour towards the cell
+		int fromX = cellX - FireTerrain::offsetX(n);
+		int fromY = cellY - FireTerrain::offsetY(n);
+		if (fromX < 0 || fromY < 0 || fromX >= cols || fromY >= rows)
+			continue;
+		int from = fromY * cols + fromX;
+		if (cellFlags[from] & cellAccepted)
+			time = std::min(time, arrivalTimes[from] + delays[fuelModels[from]][model][n][terrain->getSlopeBand(n, from)]);
+	}
+
+	time = std::max(time, acceptedTime);
+	if (time < arrivalTimes[index]) {
+		arrivalTimes[index] = time;
+		heap.push_back(std::make_pair(time, index));
+		std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<float, int> >());
+	}
+}
+
+int FireArrivalTime::getCellState(int index, float time) const {
+	float arrival = arrivalTimes[index];
+	if (time < arrival)
+		return FireSpreadEngine::UNBURNT;
+	if (time < arrival + burnDurations[index])
+		return FireSpreadEngine::BURNING;
+	return FireSpreadEngine::EXTINGUISHED;
+}
+
+// Position in reachedCells of the first cell reached after a time
+int FireArrivalTime::firstReachedAfter(float time) const {
+	const std::vector<float>& times = arrivalTimes;
+	return static_cast<int>(std::upper_bound(reachedCells.begin(), reachedCells.end(), time,
+		[&times](float t, int index) { return t < times[index]; }) - reachedCells.begin());
+}
+
+// The cells are sorted by arrival time, so the cells that caught fire are a range of reachedCells, and the cells
+// that burnt out are in the range of the cells that caught fire up to maximumBurnDuration time steps earlier
+// (a cell that caught fire and burnt out in between is appended twice)
+void FireArrivalTime::getChangedCells(float from, float to, std::vector<int>& cells) const {
+	float low = std::min(from, to);
+	float high = std::max(from, to);
+	int ignitedEnd = firstReachedAfter(high);
+	for (int i = firstReachedAfter(low); i < ignitedEnd; i++)
+		cells.push_back(reachedCells[i]);
+	for (int i = firstReachedAfter(low - FireSpreadEngine::maximumBurnDuration); i < ignitedEnd; i++) {
+		int index = reachedCells[i];
+		float extinguished = arrivalTimes[index] + burnDurations[index];
+		if (extinguished > low && extinguished <= high)
+			cells.push_back(index);
+	}
+}
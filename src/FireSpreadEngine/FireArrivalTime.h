@@ -0,0 +1,86 @@
+/***********************************************************************
+FireArrivalTime - deterministic version of the fire spread model: the
+time step at which the fire reaches every cell of the raster, computed
+once with a fast marching pass from the starting point. The state of
+the fire at any time is then read from the arrival times, so a scenario
+can be scrubbed forwards and backwards without running the model again.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "FireSpreadEngine.h"
+#include "FireTerrain.h"
+
+class FireArrivalTime {
+public:
+	FireArrivalTime();
+
+	// Arrival time of a fire starting on the cell (x, y) at time 0, on the terrain and with the model parameters
+	// and protected cells of the engine. Returns false if the cell cannot burn (outside, water, protected or non burnable).
+	bool solve(const FireSpreadEngine& engine, int x, int y);
+
+	int getCols() const {
+		return cols;
+	}
+	int getRows() const {
+		return rows;
+	}
+
+	// Time step at which the fire reaches a cell (packed index y * cols + x), infinity if it never does
+	float getArrivalTime(int index) const {
+		return arrivalTimes[index];
+	}
+	const std::vector<float>& getArrivalTimes() const {
+		return arrivalTimes;
+	}
+	// Cells reached by the fire, by increasing arrival time
+	const std::vector<int>& getReachedCells() const {
+		return reachedCells;
+	}
+
+	// State of a cell at a time (FireSpreadEngine::CellState): a cell burns for the burn duration of its fuel model
+	// from its arrival time. Protected cells and cells that the fire never reaches are UNBURNT.
+	int getCellState(int index, float time) const;
+	// Appends the cells that caught fire or burnt out between two times (in either order) to cells
+	void getChangedCells(float from, float to, std::vector<int>& cells) const;
+
+	// Number of time steps for a burning cell to set a neighbour on fire (median, at least 1), when the probability
+	// of the spread at every time step is probability (0 - 1) and the spread happens before the cell burns out
+	// (burnDuration time steps)
+	static float spreadDelay(float probability, int burnDuration);
+
+private:
+	void updateCell(int index, float acceptedTime);
+	int firstReachedAfter(float time) const;
+
+	int cols, rows;
+	int neighbours;		// 4 or 8 (FireSpreadEngine::getNumberOfNeighbours())
+	const FireTerrain* terrain;
+	std::vector<float> arrivalTimes;
+	std::vector<unsigned char> cellFlags;	// cellAccepted, cellBlocked
+	std::vector<unsigned char> burnDurations;	// burn duration of the fuel model of every cell
+	std::vector<int> reachedCells;
+	std::vector<std::pair<float, int> > heap;	// tentative arrival times of the cells next to the accepted cells
+	// spread delay from a burning cell towards each neighbour, by fuel model of the burning cell and of the neighbour
+	// and slope band
+	float delays[FireSpreadEngine::numberOfFuelModels][FireSpreadEngine::numberOfFuelModels][FireTerrain::numberOfNeighbours][FireTerrain::numberOfSlopeBands];
+};
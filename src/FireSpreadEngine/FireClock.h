@@ -0,0 +1,72 @@
+/***********************************************************************
+FireClock - fixed time step clock of the fire spread model. The model
+runs a fixed number of time steps per second of real time, whatever the
+frame rate of the application: every frame runs the time steps that are
+due since the previous frame.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+class FireClock {
+public:
+	FireClock()
+	:ticksPerSecond(10),
+	maximumTicksPerFrame(20),
+	pendingTicks(0)
+	{
+	}
+
+	// Speed of the simulation, in time steps per second of real time
+	void setTicksPerSecond(double sticksPerSecond) {
+		ticksPerSecond = sticksPerSecond > 0 ? sticksPerSecond : 0;
+	}
+	double getTicksPerSecond() const {
+		return ticksPerSecond;
+	}
+
+	// Time steps run in one frame at most, so that a slow frame (or a speed the computer cannot keep up with)
+	// slows the simulation down instead of making the next frames even slower
+	void setMaximumTicksPerFrame(int ticks) {
+		maximumTicksPerFrame = ticks > 1 ? ticks : 1;
+	}
+
+	// Time elapsed since the previous frame (in seconds), returns the number of time steps to run in this frame
+	int advance(double elapsed) {
+		if (elapsed > 0)
+			pendingTicks += elapsed * ticksPerSecond;
+		int ticks = static_cast<int>(pendingTicks);
+		if (ticks > maximumTicksPerFrame) {
+			// the late time steps are dropped
+			pendingTicks = 0;
+			return maximumTicksPerFrame;
+		}
+		pendingTicks -= ticks;
+		return ticks;
+	}
+
+	// Forgets the time elapsed since the last time step
+	void reset() {
+		pendingTicks = 0;
+	}
+
+private:
+	double ticksPerSecond;
+	int maximumTicksPerFrame;
+	double pendingTicks;	// time steps due, including the fraction of the next one
+};
@@ -0,0 +1,155 @@
+/***********************************************************************
+FireEnsemble - Monte Carlo ensemble of the fire spread model.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireEnsemble.h"
+
+#include <algorithm>
+
+FireEnsemble::FireEnsemble()
+:windAngle(0),
+windVelocity(0),
+neighbourhood(FireSpreadEngine::VON_NEUMANN),
+startX(0),
+startY(0),
+numberOfRealizations(0),
+maximumTicks(0),
+seed(0),
+running(false),
+finished(false),
+cancelled(false),
+completedRealizations(0)
+{
+	setNumberOfThreads(static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+FireEnsemble::~FireEnsemble() {
+	cancel();
+}
+
+void FireEnsemble::setNumberOfThreads(int threads) {
+	cancel();
+	threadPool.setNumberOfThreads(threads);
+	threads = threadPool.getNumberOfThreads();
+
+	// the realizations are the parallel tasks, the engines step on a single thread each
+	engines.resize(threads);
+	for (int thread = 0; thread < threads; thread++) {
+		if (!engines[thread]) {
+			engines[thread].reset(new FireSpreadEngine());
+			engines[thread]->setNumberOfThreads(1);
+		}
+	}
+	burnCounts.resize(threads);
+}
+
+void FireEnsemble::start(const FireSpreadEngine& engine, int x, int y, int realizations, int sticks, unsigned int sseed) {
+	cancel();
+
+	// Snapshot of the scenario, the engine of the application keeps running while the ensemble runs
+	terrain = engine.getTerrain();
+	windAngle = engine.getWindAngle();
+	windVelocity = engine.getWindVelocity();
+	neighbourhood = engine.getNeighbourhood();
+	protectedCells.clear();
+	const FireStateRaster& state = engine.getStateRaster();
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		for (uint64_t bits = low[w] & high[w]; bits; bits &= bits - 1)
+			protectedCells.push_back(w * 64 + FireStateRaster::lowestBit(bits));
+	}
+	startX = x;
+	startY = y;
+	numberOfRealizations = std::max(realizations, 0);
+	maximumTicks = sticks;
+	seed = sseed;
+
+	finished = false;
+	cancelled = false;
+	completedRealizations = 0;
+	running = true;
+	runner = std::thread(&FireEnsemble::run, this);
+}
+
+void FireEnsemble::cancel() {
+	cancelled = true;
+	if (runner.joinable())
+		runner.join();
+	running = false;
+}
+
+void FireEnsemble::run() {
+	int cols = terrain.getCols();
+	for (size_t thread = 0; thread < engines.size(); thread++) {
+		FireSpreadEngine& engine = *engines[thread];
+		engine.setup(terrain);
+		engine.setWind(windAngle, windVelocity);
+		engine.setNeighbourhood(neighbourhood);
+		// clearFire() keeps the protected cells between two realizations
+		for (size_t i = 0; i < protectedCells.size(); i++)
+			engine.protect(protectedCells[i] % cols, protectedCells[i] / cols);
+		burnCounts[thread].assign(cols * terrain.getRows(), 0);
+	}
+
+	threadPool.run(numberOfRealizations, [this](int realization, int thread) {
+		runRealization(realization, thread);
+	});
+
+	if (!cancelled) {
+		burnProbabilities.assign(cols * terrain.getRows(), 0);
+		for (size_t thread = 0; thread < burnCounts.size(); thread++) {
+			const std::vector<int>& counts = burnCounts[thread];
+			for (size_t i = 0; i < counts.size(); i++)
+				burnProbabilities[i] += counts[i];
+		}
+		float scale = numberOfRealizations > 0 ? 1.0f / numberOfRealizations : 0;
+		for (size_t i = 0; i < burnProbabilities.size(); i++)
+			burnProbabilities[i] *= scale;
+		finished = true;
+	}
+	running = false;
+}
+
+void FireEnsemble::runRealization(int realization, int thread) {
+	if (cancelled)
+		return;
+
+	FireSpreadEngine& engine = *engines[thread];
+	engine.clearFire();
+	engine.setSeed(FireRandom::mix(seed ^ FireRandom::mix(static_cast<uint32_t>(realization) + 0x9e3779b9u)));
+	if (engine.ignite(startX, startY)) {
+		for (int tick = 0; tick < maximumTicks && engine.getNumberOfBurningCells() > 0; tick++) {
+			if (cancelled)
+				return;
+			engine.step();
+		}
+	}
+
+	// Cells burning or extinguished at the end of the realization (protected cells have both bits set)
+	const FireStateRaster& state = engine.getStateRaster();
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	int* counts = burnCounts[thread].data();
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		for (uint64_t bits = low[w] ^ high[w]; bits; bits &= bits - 1)
+			counts[w * 64 + FireStateRaster::lowestBit(bits)]++;
+	}
+	completedRealizations++;
+}
@@ -0,0 +1,107 @@
+/***********************************************************************
+FireEnsemble - Monte Carlo ensemble of the fire spread model. Runs many
+realizations of the model from the same terrain, model parameters,
+protected cells and starting point (only the seed changes) and counts
+how often every cell burns: the burn probability of the cells.
+The realizations run in the background on worker threads, every thread
+steps its own FireSpreadEngine on a copy of the terrain shared by all
+of them.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "FireSpreadEngine.h"
+#include "FireTerrain.h"
+#include "FireThreadPool.h"
+
+class FireEnsemble {
+public:
+	FireEnsemble();
+	// Cancels the running ensemble
+	~FireEnsemble();
+
+	// Threads running the realizations, all the cores of the processor by default
+	void setNumberOfThreads(int threads);
+	int getNumberOfThreads() const {
+		return static_cast<int>(engines.size());
+	}
+
+	// Starts an ensemble in the background, the previous one is cancelled if it is still running.
+	// The terrain (with the fuel models), model parameters and protected cells are copied from the engine. Every realization starts
+	// with a fire on the cell (x, y) and runs until the fire is out or for maximumTicks time steps.
+	// The realizations only depend on the seed: the burn probabilities are the same whatever the number of threads.
+	void start(const FireSpreadEngine& engine, int x, int y, int realizations, int maximumTicks, unsigned int seed);
+	void cancel();
+
+	bool isRunning() const {
+		return running;
+	}
+	// The burn probabilities of the last ensemble are available (it was not cancelled)
+	bool isFinished() const {
+		return finished;
+	}
+	int getNumberOfRealizations() const {
+		return numberOfRealizations;
+	}
+	int getCompletedRealizations() const {
+		return completedRealizations;
+	}
+
+	// Fraction of the realizations in which each cell caught fire, row-major (cols * rows values)
+	// Only valid when isFinished()
+	const std::vector<float>& getBurnProbabilities() const {
+		return burnProbabilities;
+	}
+	int getCols() const {
+		return terrain.getCols();
+	}
+	int getRows() const {
+		return terrain.getRows();
+	}
+
+private:
+	void run();
+	void runRealization(int realization, int thread);
+
+	FireTerrain terrain;	// read by the engines of every thread
+	std::vector<std::unique_ptr<FireSpreadEngine> > engines;	// one per thread
+	std::vector<std::vector<int> > burnCounts;		// one per thread
+	std::vector<float> burnProbabilities;
+	FireThreadPool threadPool;
+	std::thread runner;
+
+	// Scenario of the ensemble
+	float windAngle, windVelocity;
+	FireSpreadEngine::Neighbourhood neighbourhood;
+	std::vector<int> protectedCells;
+	int startX, startY;
+	int numberOfRealizations;
+	int maximumTicks;
+	unsigned int seed;
+
+	std::atomic<bool> running;
+	std::atomic<bool> finished;
+	std::atomic<bool> cancelled;
+	std::atomic<int> completedRealizations;
+};
@@ -0,0 +1,268 @@
+/***********************************************************************
+FireGridKernels - kernels of the grid step of the fire spread model.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireGridKernels.h"
+#include "FireStateRaster.h"
+
+// SSE2 is part of every x86-64 processor, AVX2 is checked at run time
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FIRE_GRID_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FIRE_TARGET_AVX2
+#else
+#define FIRE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/***
+PORTABLE C++
+***/
+
+static int ignitePortable(uint32_t* counters, int32_t* thresholds, int count, const FireRandom& random, uint32_t* ignitions) {
+	int ignited = 0;
+	for (int i = 0; i < count; i++) {
+		// no branch on the (random) outcome
+		ignitions[ignited] = counters[i];
+		ignited += static_cast<int>(random.draw15(counters[i])) <= thresholds[i];
+	}
+	return ignited;
+}
+
+static void burnPortable(unsigned char* fuel, const uint64_t* burning, const int* words, int count, uint64_t* extinguished) {
+	for (int i = 0; i < count; i++) {
+		uint64_t cells = burning[words[i]];
+		unsigned char* wordFuel = fuel + 64 * words[i];
+		uint64_t empty = 0;
+		while (cells) {
+			int bit = FireStateRaster::lowestBit(cells);
+			cells &= cells - 1;
+			wordFuel[bit]--;
+			if (wordFuel[bit] == 0)
+				empty |= static_cast<uint64_t>(1) << bit;
+		}
+		extinguished[i] = empty;
+	}
+}
+
+#ifdef FIRE_GRID_X86
+
+/***
+SIMD kernels
+The attempts are padded with attempts that always fail (threshold -1), so the vector loops do not need a scalar tail.
+Fuel: cells that are not burning have no fuel, a saturated subtraction leaves them at 0.
+***/
+static inline void padDraws(uint32_t* counters, int32_t* thresholds, int count, int padding) {
+	for (int i = 0; i < padding; i++) {
+		counters[count + i] = 0;
+		thresholds[count + i] = -1;
+	}
+}
+
+// Appends the counters of the successful attempts of a group, fire: one bit per attempt of the group
+static inline int appendIgnitions(const uint32_t* counters, int fire, uint32_t* ignitions, int ignited) {
+	while (fire) {
+		int i = FireStateRaster::lowestBit(static_cast<uint64_t>(fire));
+		fire &= fire - 1;
+		ignitions[ignited++] = counters[i];
+	}
+	return ignited;
+}
+
+/***
+SSE2 - 4 attempts per vector
+***/
+
+// 32 bit multiplication of 4 lanes (_mm_mullo_epi32 needs SSE4.1)
+static inline __m128i mulloSSE2(__m128i a, __m128i b) {
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// FireRandom::mix() of 4 lanes
+static inline __m128i mixSSE2(__m128i x) {
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	x = mulloSSE2(x, _mm_set1_epi32(static_cast<int>(FireRandom::mixMultiplier0)));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+	x = mulloSSE2(x, _mm_set1_epi32(static_cast<int>(FireRandom::mixMultiplier1)));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	return x;
+}
+
+static int igniteSSE2(uint32_t* counters, int32_t* thresholds, int count, const FireRandom& random, uint32_t* ignitions) {
+	padDraws(counters, thresholds, count, 4);
+
+	const __m128i key0 = _mm_set1_epi32(static_cast<int>(random.key0));
+	const __m128i key1 = _mm_set1_epi32(static_cast<int>(random.key1));
+	int ignited = 0;
+	for (int i = 0; i < count; i += 4) {
+		__m128i counter = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counters + i));
+		__m128i randoms = _mm_srli_epi32(mixSSE2(_mm_xor_si128(mixSSE2(_mm_xor_si128(counter, key0)), key1)), 17);
+		__m128i threshold = _mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds + i));
+		int fire = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(randoms, threshold))) ^ 0xf;
+		ignited = appendIgnitions(counters + i, fire, ignitions, ignited);
+	}
+	return ignited;
+}
+
+static void burnSSE2(unsigned char* fuel, const uint64_t* burning, const int* words, int count, uint64_t* extinguished) {
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i zero = _mm_setzero_si128();
+	for (int i = 0; i < count; i++) {
+		__m128i* p = reinterpret_cast<__m128i*>(fuel + 64 * words[i]);
+		uint64_t empty = 0;
+		for (int chunk = 0; chunk < 4; chunk++) {
+			__m128i f = _mm_subs_epu8(_mm_loadu_si128(p + chunk), one);
+			_mm_storeu_si128(p + chunk, f);
+			empty |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(f, zero))) << (16 * chunk);
+		}
+		extinguished[i] = empty & burning[words[i]];
+	}
+}
+
+/***
+AVX2 - 8 attempts per vector
+***/
+
+// FireRandom::mix() of 8 lanes
+FIRE_TARGET_AVX2 static inline __m256i mixAVX2(__m256i x) {
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(FireRandom::mixMultiplier0)));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(FireRandom::mixMultiplier1)));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	return x;
+}
+
+FIRE_TARGET_AVX2 static int igniteAVX2(uint32_t* counters, int32_t* thresholds, int count, const FireRandom& random, uint32_t* ignitions) {
+	padDraws(counters, thresholds, count, 8);
+
+	const __m256i key0 = _mm256_set1_epi32(static_cast<int>(random.key0));
+	const __m256i key1 = _mm256_set1_epi32(static_cast<int>(random.key1));
+	int ignited = 0;
+	for (int i = 0; i < count; i += 8) {
+		__m256i counter = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counters + i));
+		__m256i randoms = _mm256_srli_epi32(mixAVX2(_mm256_xor_si256(mixAVX2(_mm256_xor_si256(counter, key0)), key1)), 17);
+		__m256i threshold = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(thresholds + i));
+		int fire = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(randoms, threshold))) ^ 0xff;
+		ignited = appendIgnitions(counters + i, fire, ignitions, ignited);
+	}
+	return ignited;
+}
+
+FIRE_TARGET_AVX2 static void burnAVX2(unsigned char* fuel, const uint64_t* burning, const int* words, int count, uint64_t* extinguished) {
+	const __m256i one = _mm256_set1_epi8(1);
+	const __m256i zero = _mm256_setzero_si256();
+	for (int i = 0; i < count; i++) {
+		__m256i* p = reinterpret_cast<__m256i*>(fuel + 64 * words[i]);
+		__m256i f0 = _mm256_subs_epu8(_mm256_loadu_si256(p), one);
+		__m256i f1 = _mm256_subs_epu8(_mm256_loadu_si256(p + 1), one);
+		_mm256_storeu_si256(p, f0);
+		_mm256_storeu_si256(p + 1, f1);
+		uint64_t empty0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(f0, zero)));
+		uint64_t empty1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(f1, zero)));
+		extinguished[i] = (empty0 | (empty1 << 32)) & burning[words[i]];
+	}
+}
+
+// AVX2 instructions and AVX state saved by the operating system
+static bool processorHasAVX2() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif
+
+FireGridKernels::FireGridKernels()
+:instructionSet(PORTABLE),
+igniteKernel(ignitePortable),
+burnKernel(burnPortable)
+{
+	if (!setInstructionSet(AVX2))
+		setInstructionSet(SSE2);
+}
+
+bool FireGridKernels::isSupported(InstructionSet set) {
+	switch (set) {
+	case PORTABLE:
+		return true;
+#ifdef FIRE_GRID_X86
+	case SSE2:
+		return true;
+	case AVX2: {
+		static const bool hasAVX2 = processorHasAVX2();
+		return hasAVX2;
+	}
+#endif
+	default:
+		return false;
+	}
+}
+
+bool FireGridKernels::setInstructionSet(InstructionSet set) {
+	if (!isSupported(set))
+		return false;
+
+	instructionSet = set;
+	switch (set) {
+#ifdef FIRE_GRID_X86
+	case AVX2:
+		igniteKernel = igniteAVX2;
+		burnKernel = burnAVX2;
+		break;
+	case SSE2:
+		igniteKernel = igniteSSE2;
+		burnKernel = burnSSE2;
+		break;
+#endif
+	default:
+		igniteKernel = ignitePortable;
+		burnKernel = burnPortable;
+		break;
+	}
+	return true;
+}
+
+const char* FireGridKernels::getName(InstructionSet set) {
+	switch (set) {
+	case AVX2:
+		return "AVX2";
+	case SSE2:
+		return "SSE2";
+	default:
+		return "portable";
+	}
+}
@@ -0,0 +1,80 @@
+/***********************************************************************
+FireGridKernels - kernels of the grid step of the fire spread model
+(FireSpreadEngine::GRID_STEP), working on lists of ignition attempts and
+of 64 cell words.
+There is one implementation per instruction set (AVX2, SSE2, portable
+C++), the widest one supported by the processor is picked at run time.
+All implementations give exactly the same result.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include "FireRandom.h"
+
+class FireGridKernels {
+public:
+	enum InstructionSet {
+		PORTABLE = 0,
+		SSE2 = 1,
+		AVX2 = 2
+	};
+
+	// Uses the widest instruction set supported by the processor
+	FireGridKernels();
+
+	// Returns false (and keeps the current kernels) if the processor or the build does not support the instruction set
+	bool setInstructionSet(InstructionSet set);
+	InstructionSet getInstructionSet() const {
+		return instructionSet;
+	}
+	static bool isSupported(InstructionSet set);
+	static const char* getName(InstructionSet set);
+
+	/***
+	Ignition attempts of the grid step, one per unburnt cell and burning neighbour
+		- counters[i]: counter of the random number of the attempt (FireRandom::counter())
+		- thresholds[i]: probability of the attempt, as a 15 bit threshold minus one
+	An attempt succeeds if random.draw15(counters[i]) <= thresholds[i]. The counters of the successful
+	attempts are written to ignitions (in the same order), returns their number.
+	The arrays must have room for paddingDraws more attempts, the kernels pad them with attempts that always fail.
+	***/
+	int ignite(uint32_t* counters, int32_t* thresholds, int count, const FireRandom& random, uint32_t* ignitions) const {
+		return igniteKernel(counters, thresholds, count, random, ignitions);
+	}
+	static const int paddingDraws = 8;
+
+	/***
+	Burns one unit of fuel of the burning cells of the listed words (64 cells each)
+		- burning[w]: bits of the burning cells of the word w, fuel: fuel of the cells (0 for the cells that are not burning)
+		- extinguished[i]: bits of the cells of the word words[i] that ran out of fuel
+	***/
+	void burn(unsigned char* fuel, const uint64_t* burning, const int* words, int count, uint64_t* extinguished) const {
+		burnKernel(fuel, burning, words, count, extinguished);
+	}
+
+private:
+	typedef int (*IgniteKernel)(uint32_t* counters, int32_t* thresholds, int count, const FireRandom& random, uint32_t* ignitions);
+	typedef void (*BurnKernel)(unsigned char* fuel, const uint64_t* burning, const int* words, int count, uint64_t* extinguished);
+
+	InstructionSet instructionSet;
+	IgniteKernel igniteKernel;
+	BurnKernel burnKernel;
+};
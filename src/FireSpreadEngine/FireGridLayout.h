@@ -0,0 +1,84 @@
+/***********************************************************************
+FireGridLayout - placement of the fire grid on the kinect image: the
+grid covers a rectangle of the image (the kinect ROI) with one cell
+every pitch pixels. Converts between kinect pixels and cells.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+class FireGridLayout {
+public:
+	FireGridLayout()
+	:left(0),
+	top(0),
+	pitch(1),
+	cols(1),
+	rows(1)
+	{
+	}
+
+	// Grid covering the rectangle (kinect pixels), one cell every pitch pixels (at least one cell)
+	void setup(float sleft, float stop, float width, float height, int spitch) {
+		left = sleft;
+		top = stop;
+		pitch = std::max(spitch, 1);
+		cols = std::max(static_cast<int>(width) / pitch, 1);
+		rows = std::max(static_cast<int>(height) / pitch, 1);
+	}
+
+	int getCols() const {
+		return cols;
+	}
+	int getRows() const {
+		return rows;
+	}
+	int getPitch() const {
+		return pitch;
+	}
+	float getLeft() const {
+		return left;
+	}
+	float getTop() const {
+		return top;
+	}
+
+	// Cell containing a kinect pixel, the cell may be outside the grid (see FireSpreadEngine::isInside())
+	int getCellX(float kinectX) const {
+		return static_cast<int>(std::floor((kinectX - left) / pitch));
+	}
+	int getCellY(float kinectY) const {
+		return static_cast<int>(std::floor((kinectY - top) / pitch));
+	}
+
+	// Kinect pixel of a cell, where its elevation is sampled
+	float getKinectX(int x) const {
+		return left + x * pitch;
+	}
+	float getKinectY(int y) const {
+		return top + y * pitch;
+	}
+
+private:
+	float left, top;
+	int pitch;
+	int cols, rows;
+};
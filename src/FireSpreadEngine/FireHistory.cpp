@@ -0,0 +1,125 @@
+/***********************************************************************
+FireHistory - snapshots of the fire spread model.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireHistory.h"
+
+FireHistory::FireHistory()
+:capacity(3600),
+current(-1)
+{
+}
+
+void FireHistory::setCapacity(int snapshots) {
+	capacity = snapshots > 1 ? snapshots : 1;
+	if (getNumberOfSnapshots() > capacity) {
+		// the current state must stay in the ring: the newest snapshots are kept
+		moveTo(getNumberOfSnapshots() - 1);
+		while (getNumberOfSnapshots() > capacity)
+			dropOldest();
+	}
+}
+
+// The second oldest snapshot becomes the oldest one: it has no changes
+void FireHistory::dropOldest() {
+	snapshots.pop_front();
+	snapshots.front().positions.clear();
+	snapshots.front().changes.clear();
+	current--;
+}
+
+void FireHistory::clear() {
+	snapshots.clear();
+	current = -1;
+	currentState.clear();
+}
+
+void FireHistory::record(const FireSpreadEngine& engine) {
+	int size = engine.getStateSize();
+	if (static_cast<int>(currentState.size()) != size)
+		clear();
+	// the snapshots after the current one are lost, the fire continues from it
+	if (current >= 0)
+		snapshots.resize(current + 1);
+
+	engineState.resize(size);
+	engine.saveState(engineState.data());
+	Snapshot snapshot;
+	snapshot.tick = engine.getTick();
+	if (current >= 0) {
+		for (int i = 0; i < size; i++) {
+			uint64_t change = engineState[i] ^ currentState[i];
+			if (change) {
+				snapshot.positions.push_back(static_cast<uint32_t>(i));
+				snapshot.changes.push_back(change);
+			}
+		}
+	}
+	snapshots.push_back(snapshot);
+	currentState.swap(engineState);
+	current = getNumberOfSnapshots() - 1;
+
+	if (getNumberOfSnapshots() > capacity)
+		dropOldest();
+}
+
+bool FireHistory::restore(int snapshot, FireSpreadEngine& engine) {
+	if (snapshot < 0 || snapshot >= getNumberOfSnapshots() || static_cast<int>(currentState.size()) != engine.getStateSize())
+		return false;
+	moveTo(snapshot);
+	engine.restoreState(currentState.data());
+	return true;
+}
+
+// Applies the changes between the current snapshot and another one to the current state
+void FireHistory::moveTo(int snapshot) {
+	while (current < snapshot) {
+		current++;
+		const Snapshot& next = snapshots[current];
+		for (size_t i = 0; i < next.positions.size(); i++)
+			currentState[next.positions[i]] ^= next.changes[i];
+	}
+	while (current > snapshot) {
+		const Snapshot& previous = snapshots[current];
+		for (size_t i = 0; i < previous.positions.size(); i++)
+			currentState[previous.positions[i]] ^= previous.changes[i];
+		current--;
+	}
+}
+
+int FireHistory::findSnapshot(unsigned int tick) const {
+	// the time steps of the snapshots increase (the history is cleared with the fire)
+	int first = 0;
+	int last = getNumberOfSnapshots();
+	while (first < last) {
+		int middle = (first + last) / 2;
+		if (snapshots[middle].tick <= tick)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first - 1;
+}
+
+size_t FireHistory::getMemoryUsage() const {
+	size_t bytes = (currentState.capacity() + engineState.capacity()) * sizeof(uint64_t);
+	for (size_t i = 0; i < snapshots.size(); i++)
+		bytes += sizeof(Snapshot) + snapshots[i].positions.capacity() * sizeof(uint32_t) + snapshots[i].changes.capacity() * sizeof(uint64_t);
+	return bytes;
+}
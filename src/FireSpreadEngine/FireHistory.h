@@ -0,0 +1,89 @@
+/***********************************************************************
+FireHistory - snapshots of the fire spread model, to rewind a fire and
+replay it from an earlier time step (on the current topography). The
+snapshots are the packed states of FireSpreadEngine, stored as the
+words that changed since the previous snapshot in a bounded ring: the
+oldest snapshot is dropped when the ring is full.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "FireSpreadEngine.h"
+
+class FireHistory {
+public:
+	FireHistory();
+
+	// Snapshots kept at most, 3600 by default
+	void setCapacity(int snapshots);
+	int getCapacity() const {
+		return capacity;
+	}
+	void clear();
+
+	// Appends a snapshot of the engine after the current snapshot: the snapshots after it (the fire that was rewound)
+	// are dropped, and the oldest snapshot when the ring is full. The history is cleared when the raster changes.
+	void record(const FireSpreadEngine& engine);
+	// Restores the engine to a snapshot (0 is the oldest), returns false if the raster has changed since.
+	// The cost depends on the number of words that changed between the current snapshot and this one.
+	// The fire replayed from a snapshot is the same as the one recorded on the same terrain, except with the event
+	// step (its spreads are drawn again from the restored state).
+	bool restore(int snapshot, FireSpreadEngine& engine);
+
+	int getNumberOfSnapshots() const {
+		return static_cast<int>(snapshots.size());
+	}
+	// Snapshot restored last, or the last one recorded
+	int getCurrentSnapshot() const {
+		return current;
+	}
+	// Time step of the engine when a snapshot was recorded
+	unsigned int getTick(int snapshot) const {
+		return snapshots[snapshot].tick;
+	}
+	// Last snapshot recorded at or before a time step, -1 if there is none
+	int findSnapshot(unsigned int tick) const;
+	// Bytes used by the snapshots
+	size_t getMemoryUsage() const;
+
+private:
+	void moveTo(int snapshot);
+	void dropOldest();
+
+	/***
+	Snapshot: the words of the packed state that differ from the previous snapshot, as their position and the
+	XOR of the two values. The same changes go from one snapshot to the next one or back, so the state of any
+	snapshot is rebuilt from the state of the current snapshot. The oldest snapshot has no changes.
+	***/
+	struct Snapshot {
+		unsigned int tick;
+		std::vector<uint32_t> positions;
+		std::vector<uint64_t> changes;
+	};
+	std::deque<Snapshot> snapshots;
+	int capacity;
+	int current;
+	std::vector<uint64_t> currentState;		// packed state of the current snapshot
+	std::vector<uint64_t> engineState;
+};
@@ -0,0 +1,290 @@
+/***********************************************************************
+FirePerimeter - perimeters of the fire as closed polylines.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FirePerimeter.h"
+
+#include <algorithm>
+#include <fstream>
+
+/***
+Segments of a square for every combination of its corners inside the layer (bit 0: top left, 1: top right,
+2: bottom right, 3: bottom left), as pairs of edges of the square (0: top, 1: right, 2: bottom, 3: left), -1 when
+unused. Walking clockwise around the square, a segment goes from the edge entering the layer to the next edge leaving
+it: the segments of neighbouring squares join head to tail, and the diagonal cells of the saddles (5 and 10) stay
+apart. With the Moore neighbourhood the fire also spreads across such a corner, but the outlines are still traced
+around 4-connected cells, as the front length of the engine is measured.
+***/
+static const signed char squareSegments[16][4] = {
+	{-1, -1, -1, -1},
+	{3, 0, -1, -1},
+	{0, 1, -1, -1},
+	{3, 1, -1, -1},
+	{1, 2, -1, -1},
+	{1, 2, 3, 0},
+	{0, 2, -1, -1},
+	{3, 2, -1, -1},
+	{2, 3, -1, -1},
+	{2, 0, -1, -1},
+	{0, 1, 2, 3},
+	{2, 1, -1, -1},
+	{1, 3, -1, -1},
+	{1, 0, -1, -1},
+	{0, 3, -1, -1},
+	{-1, -1, -1, -1}
+};
+
+FirePerimeter::FirePerimeter()
+:cols(0),
+rows(0),
+tileCols(0),
+tileRows(0),
+horizontalEdges(0),
+pass(0)
+{
+	for (int layer = 0; layer < numberOfLayers; layer++)
+		polylineStarts[layer].assign(1, 0);
+}
+
+void FirePerimeter::setup(int scols, int srows) {
+	cols = scols;
+	rows = srows;
+	tileCols = (cols + tileSize) / tileSize;
+	tileRows = (rows + tileSize) / tileSize;
+	int words = (cols * rows + 63) / 64;
+	low.assign(words, 0);
+	high.assign(words, 0);
+	dirty.assign(tileCols * tileRows, 0);
+	dirtyTiles.clear();
+	horizontalEdges = (cols + 1) * (rows + 2);
+	nextPoint.assign(horizontalEdges + (cols + 2) * (rows + 1), 0);
+	seen.assign(nextPoint.size(), 0);
+	pass = 0;
+	for (int layer = 0; layer < numberOfLayers; layer++) {
+		segments[layer].assign(tileCols * tileRows, std::vector<Segment>());
+		points[layer].clear();
+		polylineStarts[layer].assign(1, 0);
+	}
+}
+
+void FirePerimeter::clear() {
+	setup(cols, rows);
+}
+
+bool FirePerimeter::update(const FireSpreadEngine& engine) {
+	if (engine.getCols() != cols || engine.getRows() != rows)
+		setup(engine.getCols(), engine.getRows());
+
+	const FireStateRaster& state = engine.getStateRaster();
+	const uint64_t* newLow = state.getLowBits();
+	const uint64_t* newHigh = state.getHighBits();
+	for (int w = 0; w < static_cast<int>(low.size()); w++) {
+		for (uint64_t changed = (newLow[w] ^ low[w]) | (newHigh[w] ^ high[w]); changed; changed &= changed - 1)
+			markTiles(64 * w + FireStateRaster::lowestBit(changed));
+	}
+	if (dirtyTiles.empty())
+		return false;
+
+	for (int tile : dirtyTiles) {
+		traceTile(tile, newLow, newHigh);
+		dirty[tile] = 0;
+	}
+	dirtyTiles.clear();
+	std::copy(newLow, newLow + low.size(), low.begin());
+	std::copy(newHigh, newHigh + high.size(), high.begin());
+
+	// the points seen in this pass are marked with pass, the points already added to a polyline with pass + 1
+	if (pass >= 0xfffffff0u) {
+		std::fill(seen.begin(), seen.end(), 0);
+		pass = 0;
+	}
+	for (int layer = 0; layer < numberOfLayers; layer++) {
+		pass += 2;
+		joinSegments(static_cast<Layer>(layer));
+	}
+	return true;
+}
+
+// A cell is a corner of the squares (x, y) to (x + 1, y + 1)
+void FirePerimeter::markTiles(int index) {
+	int x = index % cols;
+	int y = index / cols;
+	for (int ty = y / tileSize; ty <= (y + 1) / tileSize; ty++) {
+		for (int tx = x / tileSize; tx <= (x + 1) / tileSize; tx++) {
+			int tile = ty * tileCols + tx;
+			if (!dirty[tile]) {
+				dirty[tile] = 1;
+				dirtyTiles.push_back(tile);
+			}
+		}
+	}
+}
+
+// State of a cell, the cells outside the raster are unburnt
+static inline int getCellState(const uint64_t* low, const uint64_t* high, int cols, int rows, int x, int y) {
+	if (x < 0 || y < 0 || x >= cols || y >= rows)
+		return FireSpreadEngine::UNBURNT;
+	int index = y * cols + x;
+	int bit = index & 63;
+	return static_cast<int>(((low[index >> 6] >> bit) & 1) | (((high[index >> 6] >> bit) & 1) << 1));
+}
+
+void FirePerimeter::traceTile(int tile, const uint64_t* low, const uint64_t* high) {
+	int firstI = (tile % tileCols) * tileSize;
+	int firstJ = (tile / tileCols) * tileSize;
+	int lastI = std::min(firstI + tileSize, cols + 1);
+	int lastJ = std::min(firstJ + tileSize, rows + 1);
+	for (int layer = 0; layer < numberOfLayers; layer++)
+		segments[layer][tile].clear();
+
+	for (int j = firstJ; j < lastJ; j++) {
+		// the right corners of a square are the left corners of the next one
+		int topRight = getCellState(low, high, cols, rows, firstI - 1, j - 1);
+		int bottomRight = getCellState(low, high, cols, rows, firstI - 1, j);
+		for (int i = firstI; i < lastI; i++) {
+			int topLeft = topRight;
+			int bottomLeft = bottomRight;
+			topRight = getCellState(low, high, cols, rows, i, j - 1);
+			bottomRight = getCellState(low, high, cols, rows, i, j);
+			if ((topLeft | topRight | bottomRight | bottomLeft) == FireSpreadEngine::UNBURNT)
+				continue;
+
+			int edges[4] = {
+				j * (cols + 1) + i,							// top: horizontal edge from (i - 1, j - 1)
+				horizontalEdges + j * (cols + 2) + i + 1,	// right: vertical edge from (i, j - 1)
+				(j + 1) * (cols + 1) + i,					// bottom: horizontal edge from (i - 1, j)
+				horizontalEdges + j * (cols + 2) + i		// left: vertical edge from (i - 1, j - 1)
+			};
+			int corners[4] = { topLeft, topRight, bottomRight, bottomLeft };
+			for (int layer = 0; layer < numberOfLayers; layer++) {
+				int square = 0;
+				for (int corner = 0; corner < 4; corner++) {
+					int cell = corners[corner];
+					bool inside = layer == FRONT ? cell == FireSpreadEngine::BURNING :
+						cell == FireSpreadEngine::BURNING || cell == FireSpreadEngine::EXTINGUISHED;
+					square |= static_cast<int>(inside) << corner;
+				}
+				const signed char* squareSegment = squareSegments[square];
+				for (int s = 0; s < 4 && squareSegment[s] >= 0; s += 2) {
+					Segment segment = { edges[squareSegment[s]], edges[squareSegment[s + 1]] };
+					segments[layer][tile].push_back(segment);
+				}
+			}
+		}
+	}
+}
+
+// Follows the segments of every tile from point to point until the polyline is closed
+void FirePerimeter::joinSegments(Layer layer) {
+	std::vector<std::vector<Segment> >& tileSegments = segments[layer];
+	for (size_t tile = 0; tile < tileSegments.size(); tile++) {
+		for (const Segment& segment : tileSegments[tile]) {
+			nextPoint[segment.from] = segment.to;
+			seen[segment.from] = pass;
+		}
+	}
+
+	std::vector<Point>& layerPoints = points[layer];
+	std::vector<int>& starts = polylineStarts[layer];
+	layerPoints.clear();
+	starts.clear();
+	for (size_t tile = 0; tile < tileSegments.size(); tile++) {
+		for (const Segment& segment : tileSegments[tile]) {
+			if (seen[segment.from] != pass)
+				continue;
+			int start = static_cast<int>(layerPoints.size());
+			for (int point = segment.from; seen[point] == pass; point = nextPoint[point]) {
+				seen[point] = pass + 1;
+				addPoint(layer, start, point);
+			}
+			// the polyline is closed: the last and the first point may also be on straight lines
+			int size = static_cast<int>(layerPoints.size()) - start;
+			if (size >= 3) {
+				const Point& previous = layerPoints[start + size - 2];
+				const Point& last = layerPoints[start + size - 1];
+				const Point& first = layerPoints[start];
+				if ((last.x - previous.x) * (first.y - last.y) == (last.y - previous.y) * (first.x - last.x)) {
+					layerPoints.pop_back();
+					size--;
+				}
+			}
+			if (size >= 3) {
+				const Point& last = layerPoints[start + size - 1];
+				const Point& first = layerPoints[start];
+				const Point& second = layerPoints[start + 1];
+				if ((first.x - last.x) * (second.y - first.y) == (first.y - last.y) * (second.x - first.x))
+					layerPoints.erase(layerPoints.begin() + start);
+			}
+			starts.push_back(start);
+		}
+	}
+	starts.push_back(static_cast<int>(layerPoints.size()));
+}
+
+// Adds the crossing point on an edge to the polyline that starts at start, the previous point is replaced when the
+// three points are on a straight line (the coordinates are multiples of 0.5, the test is exact)
+void FirePerimeter::addPoint(Layer layer, int start, int edge) {
+	Point point;
+	if (edge < horizontalEdges) {
+		point.x = edge % (cols + 1) - 0.5f;
+		point.y = static_cast<float>(edge / (cols + 1) - 1);
+	}
+	else {
+		edge -= horizontalEdges;
+		point.x = static_cast<float>(edge % (cols + 2) - 1);
+		point.y = edge / (cols + 2) - 0.5f;
+	}
+	std::vector<Point>& layerPoints = points[layer];
+	int size = static_cast<int>(layerPoints.size()) - start;
+	if (size >= 2) {
+		const Point& previous = layerPoints[layerPoints.size() - 2];
+		const Point& last = layerPoints.back();
+		if ((last.x - previous.x) * (point.y - last.y) == (last.y - previous.y) * (point.x - last.x)) {
+			layerPoints.back() = point;
+			return;
+		}
+	}
+	layerPoints.push_back(point);
+}
+
+bool FirePerimeter::save(const std::string& path, float originX, float originY, float cellSize) const {
+	std::ofstream out(path.c_str(), std::ios::trunc);
+	if (!out)
+		return false;
+	const char* layerNames[numberOfLayers] = { "front", "scar" };
+	out << "{\"type\": \"FeatureCollection\", \"features\": [";
+	for (int layer = 0; layer < numberOfLayers; layer++) {
+		out << (layer > 0 ? ",\n" : "\n") << "{\"type\": \"Feature\", \"properties\": {\"layer\": \"" << layerNames[layer]
+			<< "\"}, \"geometry\": {\"type\": \"MultiLineString\", \"coordinates\": [";
+		const std::vector<Point>& layerPoints = points[layer];
+		const std::vector<int>& starts = polylineStarts[layer];
+		for (int polyline = 0; polyline + 1 < static_cast<int>(starts.size()); polyline++) {
+			out << (polyline > 0 ? ",\n[" : "\n[");
+			// the first point is repeated at the end to close the line
+			for (int i = starts[polyline]; i <= starts[polyline + 1]; i++) {
+				const Point& point = layerPoints[i < starts[polyline + 1] ? i : starts[polyline]];
+				out << (i > starts[polyline] ? ", [" : "[") << originX + point.x * cellSize << ", " << originY + point.y * cellSize << "]";
+			}
+			out << "]";
+		}
+		out << "]}}";
+	}
+	out << "\n]}\n";
+	return static_cast<bool>(out);
+}
@@ -0,0 +1,109 @@
+/***********************************************************************
+FirePerimeter - perimeters of the fire as closed polylines, extracted
+from the state raster of FireSpreadEngine with marching squares: the
+active front (outline of the burning cells) and the burn scar (outline
+of the burning and extinguished cells). Only the tiles in which a cell
+changed since the last update are traced again.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FireSpreadEngine.h"
+
+class FirePerimeter {
+public:
+	enum Layer {
+		FRONT = 0,	// burning cells
+		SCAR = 1	// burning and extinguished cells
+	};
+	static const int numberOfLayers = 2;
+
+	// Point of a polyline in cell coordinates: the centre of cell (x, y) is at (x, y)
+	struct Point {
+		float x, y;
+	};
+
+	FirePerimeter();
+
+	/***
+	Traces the tiles in which a cell changed state since the last update (found by comparing the bit planes of the
+	engine with a copy, so clearFire(), reset() and restoreState() are followed as well) and joins the segments of
+	every tile into polylines. Everything is traced again when the size of the raster changes.
+	Returns false if the perimeters did not change.
+	***/
+	bool update(const FireSpreadEngine& engine);
+	// Forgets the perimeters, the next update traces the fire again
+	void clear();
+
+	// Closed polylines of a layer: polyline i is made of the points getPolylineStarts()[i] to
+	// getPolylineStarts()[i + 1] - 1, the last point is joined to the first one. Points on straight lines are merged.
+	const std::vector<Point>& getPoints(Layer layer) const {
+		return points[layer];
+	}
+	const std::vector<int>& getPolylineStarts(Layer layer) const {
+		return polylineStarts[layer];
+	}
+	int getNumberOfPolylines(Layer layer) const {
+		return static_cast<int>(polylineStarts[layer].size()) - 1;
+	}
+
+	// Writes both layers as a GeoJSON FeatureCollection of MultiLineStrings, a cell (x, y) is at
+	// (originX + x * cellSize, originY + y * cellSize). Returns false if the file cannot be written.
+	bool save(const std::string& path, float originX, float originY, float cellSize) const;
+
+private:
+	void setup(int scols, int srows);
+	void markTiles(int index);
+	void traceTile(int tile, const uint64_t* low, const uint64_t* high);
+	void joinSegments(Layer layer);
+	void addPoint(Layer layer, int start, int edge);
+
+	// Raster and tiles of squares: square (i, j) has the centres of cells (i - 1, j - 1) to (i, j) as corners,
+	// the cells outside the raster are empty so every polyline is closed
+	int cols, rows;
+	static const int tileSize = 16;
+	int tileCols, tileRows;
+
+	/***
+	Segments of a tile, oriented so that every crossing point has one segment arriving and one leaving. The crossing
+	points are on the edges between the centres of two cells, numbered horizontal edges first:
+		- horizontal edge from (x, y) to (x + 1, y): (y + 1) * (cols + 1) + x + 1
+		- vertical edge from (x, y) to (x, y + 1): (cols + 1) * (rows + 2) + (y + 1) * (cols + 2) + x + 1
+	***/
+	struct Segment {
+		int from, to;
+	};
+	std::vector<std::vector<Segment> > segments[numberOfLayers];
+	std::vector<uint64_t> low, high;		// state bit planes traced last
+	std::vector<unsigned char> dirty;		// tiles to trace again
+	std::vector<int> dirtyTiles;
+	int horizontalEdges;
+
+	// Joining the segments: next crossing point of every crossing point, and the pass in which it was seen
+	std::vector<int> nextPoint;
+	std::vector<uint32_t> seen;
+	uint32_t pass;
+
+	std::vector<Point> points[numberOfLayers];
+	std::vector<int> polylineStarts[numberOfLayers];
+};
@@ -0,0 +1,75 @@
+/***********************************************************************
+FireRandom - counter-based random numbers of the fire spread model.
+A draw only depends on the seed, the time step and a counter (the cell
+and the neighbour the fire comes from), not on the order of the draws,
+so whole rows of cells can be evaluated at once.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+class FireRandom {
+public:
+	FireRandom()
+	:key0(0),
+	key1(0)
+	{
+	}
+
+	// Keys of the draws of one time step
+	void setKeys(uint32_t seed, uint32_t tick) {
+		key0 = mix(seed ^ mix(tick + 0x9e3779b9u));
+		key1 = mix(key0 + 0x9e3779b9u);
+	}
+
+	// Counter of the draw deciding whether the fire spreads from a neighbour (FireTerrain::Neighbour) into a cell:
+	// the cell in bits 2 - 30 (rasters of less than 2^29 cells), the neighbour in bits 0 - 1 and 31 (diagonals)
+	static uint32_t counter(uint32_t index, int neighbour) {
+		return (index << 2) | static_cast<uint32_t>(neighbour & 3) | (static_cast<uint32_t>(neighbour >> 2) << 31);
+	}
+	// Cell of a counter
+	static uint32_t cell(uint32_t counter) {
+		return (counter & 0x7fffffffu) >> 2;
+	}
+
+	// Random number between 0 and 32767
+	uint32_t draw15(uint32_t counter) const {
+		return draw32(counter) >> 17;
+	}
+	// Random number between 0 and 2^32 - 1
+	uint32_t draw32(uint32_t counter) const {
+		return mix(mix(counter ^ key0) ^ key1);
+	}
+
+	// Integer hash with a good avalanche (lowbias32, Chris Wellons), also written with SIMD in FireGridKernels
+	static uint32_t mix(uint32_t x) {
+		x ^= x >> 16;
+		x *= mixMultiplier0;
+		x ^= x >> 15;
+		x *= mixMultiplier1;
+		x ^= x >> 16;
+		return x;
+	}
+
+	static const uint32_t mixMultiplier0 = 0x7feb352du;
+	static const uint32_t mixMultiplier1 = 0x846ca68bu;
+
+	uint32_t key0, key1;
+};
@@ -0,0 +1,1115 @@
+/***********************************************************************
+FireSpreadEngine - headless version of the fire spread model of
+"Fire in the Sandbox".
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+Based on Magic Sand by Thomas Wolf (2016)
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireSpreadEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <random>
+
+/***
+Number of time steps a cell burns, indexed by VegetationType (fuel model of the cell)
+The forests burn for the 50 time steps of the original model, the fine fuels of grasslands burn out faster.
+***/
+static constexpr int burnDurations[FireSpreadEngine::numberOfFuelModels] = { 50, 20, 50, 0 };
+static_assert(burnDurations[FireSpreadEngine::EVERGREEN] <= FireSpreadEngine::maximumBurnDuration &&
+	burnDurations[FireSpreadEngine::GRASSLAND] <= FireSpreadEngine::maximumBurnDuration &&
+	burnDurations[FireSpreadEngine::PINUS] <= FireSpreadEngine::maximumBurnDuration, "burn durations");
+
+int FireSpreadEngine::getBurnDuration(VegetationType type) {
+	return burnDurations[type];
+}
+
+FireSpreadEngine::FireSpreadEngine()
+:cols(0),
+rows(0),
+terrain(&ownTerrain),
+burningCells(0),
+tick(0),
+extinguishedCells(0),
+frontEdges(0),
+ignitedCells(0),
+rateOfSpread(0),
+currentFront(0),
+frontOutdated(false),
+stepMode(AUTOMATIC_STEP),
+burningWordsOutdated(false),
+eventsOutdated(false),
+fuelOutdated(false),
+windAngle(270),
+windVelocity(0),
+neighbourhood(VON_NEUMANN),
+vegType(EVERGREEN),
+seed(std::random_device()())
+{
+	selectSpreadKernel();
+	updateIgnitionThresholds();
+	setNumberOfThreads(static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void FireSpreadEngine::setup(int scols, int srows, float scellSize) {
+	ownTerrain.setup(scols, srows, scellSize);
+	ownTerrain.fillFuelModels(vegType);
+	setup(ownTerrain);
+}
+
+void FireSpreadEngine::setup(const FireTerrain& sharedTerrain) {
+	terrain = &sharedTerrain;
+	cols = terrain->getCols();
+	rows = terrain->getRows();
+	state.setup(cols, rows);
+
+	// Rasters of the grid step are padded to whole words, the kernels read 64 cells at a time
+	int words = state.getNumberOfWords();
+	fuel.assign(words * 64, 0);
+	burningBits.assign(words + 2 * (cols / 64 + 2), 0);
+	ignitionBits.assign(words, 0);
+	visitWords.assign((words + 7) / 8 * 8, 0);
+	extinguishedBits.assign(words, 0);
+	tileIgnitedWords.resize((words + tileWords - 1) / tileWords);
+	for (size_t tile = 0; tile < tileIgnitedWords.size(); tile++)
+		tileIgnitedWords[tile].reserve(tileWords);
+	burningWords.reserve(words);
+	nextBurningWords.reserve(words);
+	ignitedWords.reserve(words);
+
+	// Every cell is at most once in a front and changes at most twice (ignited, extinguished)
+	front[0].reserve(cols * rows);
+	front[1].reserve(cols * rows);
+	changedCells.reserve(2 * cols * rows);
+	updateBurnableBits();
+	reset();
+}
+
+void FireSpreadEngine::setSeed(unsigned int sseed) {
+	seed = sseed;
+}
+
+void FireSpreadEngine::reset() {
+	state.clear();
+	std::fill(fuel.begin(), fuel.end(), 0);
+	burningCells = 0;
+	tick = 0;
+	front[0].clear();
+	front[1].clear();
+	frontOutdated = false;
+	burningWords.clear();
+	burningWordsOutdated = false;
+	clearEvents();
+	eventsOutdated = false;
+	fuelOutdated = false;
+	changedCells.clear();
+	extinguishedCells = 0;
+	frontEdges = 0;
+	ignitedCells = 0;
+	rateOfSpread = 0;
+}
+
+void FireSpreadEngine::clearFire() {
+	// only protected cells (3) have both bits set
+	uint64_t* low = state.getLowBits();
+	uint64_t* high = state.getHighBits();
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		uint64_t protectedCells = low[w] & high[w];
+		low[w] = protectedCells;
+		high[w] = protectedCells;
+	}
+	std::fill(fuel.begin(), fuel.end(), 0);
+	burningCells = 0;
+	tick = 0;
+	front[0].clear();
+	front[1].clear();
+	frontOutdated = false;
+	burningWords.clear();
+	burningWordsOutdated = false;
+	clearEvents();
+	eventsOutdated = false;
+	fuelOutdated = false;
+	changedCells.clear();
+	extinguishedCells = 0;
+	frontEdges = 0;
+	ignitedCells = 0;
+	rateOfSpread = 0;
+}
+
+/***
+Layout of the packed state, with n the number of words of the state raster:
+	- word 0: time step (low 32 bits) and seed (high 32 bits), the random numbers only depend on them
+	- words 1 to 2n: low and high bit planes of the state raster
+	- words 2n + 1 to 10n: fuel of every cell, one byte per cell, 0 for the cells that are not burning
+***/
+void FireSpreadEngine::saveState(uint64_t* words) const {
+	int n = state.getNumberOfWords();
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	words[0] = static_cast<uint64_t>(tick) | (static_cast<uint64_t>(seed) << 32);
+	std::memcpy(words + 1, low, n * sizeof(uint64_t));
+	std::memcpy(words + 1 + n, high, n * sizeof(uint64_t));
+
+	unsigned char* savedFuel = reinterpret_cast<unsigned char*>(words + 1 + 2 * n);
+	std::memset(savedFuel, 0, n * 64);
+	if (fuelOutdated) {
+		// the fuel of the burning cells is in the burnout wheel (after front and event steps)
+		for (int ahead = 0; ahead < eventBuckets; ahead++) {
+			const std::vector<int>& burnouts = burnoutWheel[(tick + ahead) % eventBuckets];
+			for (size_t i = 0; i < burnouts.size(); i++) {
+				if (state.isBurning(burnouts[i]))
+					savedFuel[burnouts[i]] = static_cast<unsigned char>(ahead + 1);
+			}
+		}
+	}
+	else {
+		for (int w = 0; w < n; w++) {
+			for (uint64_t bits = low[w] & ~high[w]; bits; bits &= bits - 1) {
+				int index = 64 * w + FireStateRaster::lowestBit(bits);
+				savedFuel[index] = fuel[index];
+			}
+		}
+	}
+}
+
+void FireSpreadEngine::restoreState(const uint64_t* words) {
+	int n = state.getNumberOfWords();
+	uint64_t* low = state.getLowBits();
+	uint64_t* high = state.getHighBits();
+	const uint64_t* savedLow = words + 1;
+	const uint64_t* savedHigh = words + 1 + n;
+	tick = static_cast<unsigned int>(words[0]);
+	seed = static_cast<unsigned int>(words[0] >> 32);
+
+	burningCells = 0;
+	for (int w = 0; w < n; w++) {
+		for (uint64_t bits = (low[w] ^ savedLow[w]) | (high[w] ^ savedHigh[w]); bits; bits &= bits - 1)
+			changedCells.push_back(64 * w + FireStateRaster::lowestBit(bits));
+		low[w] = savedLow[w];
+		high[w] = savedHigh[w];
+		burningCells += FireStateRaster::countBits(low[w] & ~high[w]);
+	}
+	std::memcpy(fuel.data(), words + 1 + 2 * n, n * 64);
+
+	front[0].clear();
+	front[1].clear();
+	clearEvents();
+	frontOutdated = true;
+	burningWordsOutdated = true;
+	eventsOutdated = true;
+	fuelOutdated = false;
+	countStatistics();
+}
+
+void FireSpreadEngine::setElevation(const float* selevation) {
+	if (terrain == &ownTerrain) {
+		ownTerrain.setElevation(selevation);
+		// cells may have become water or land
+		updateBurnableBits();
+		countStatistics();
+	}
+}
+
+void FireSpreadEngine::setElevation(const float* selevation, int x, int y, int width, int height) {
+	int firstX = std::max(x, 0);
+	int firstY = std::max(y, 0);
+	int lastX = std::min(x + width, cols);
+	int lastY = std::min(y + height, rows);
+	if (terrain != &ownTerrain || firstX >= lastX || firstY >= lastY)
+		return;
+
+	// cells of the area may become water or land: only the front edges of the burning cells in the area and around
+	// it change
+	frontEdges -= countFrontEdges(firstX - 1, firstY - 1, lastX + 1, lastY + 1);
+	ownTerrain.setElevation(selevation, firstX, firstY, lastX - firstX, lastY - firstY);
+	const uint64_t* land = terrain->getLandBits();
+	for (int cellY = firstY; cellY < lastY; cellY++) {
+		for (int index = cellY * cols + firstX; index < cellY * cols + lastX; index++) {
+			uint64_t bit = static_cast<uint64_t>(1) << (index & 63);
+			if (burnDurations[terrain->getFuelModel(index)] > 0 && (land[index >> 6] & bit))
+				burnableBits[index >> 6] |= bit;
+			else
+				burnableBits[index >> 6] &= ~bit;
+		}
+	}
+	frontEdges += countFrontEdges(firstX - 1, firstY - 1, lastX + 1, lastY + 1);
+}
+
+void FireSpreadEngine::setWind(float angle, float velocity) {
+	windAngle = angle;
+	windVelocity = std::max(velocity, 0.0f);
+	updateIgnitionThresholds();
+}
+
+// Velocity (m/s) of the wind speed columns of the table of Weise and Biging, indexed by WindSpeed
+static const float windVelocities[3] = { 0, 0.42f, 1.15f };
+
+void FireSpreadEngine::setWindSpeed(WindSpeed speed) {
+	setWind(windAngle, windVelocities[speed]);
+}
+
+void FireSpreadEngine::setWindDirection(WindDirection direction) {
+	// angle of the neighbour towards which the wind blows
+	static const float angles[4] = { 180, 0, 90, 270 };
+	setWind(angles[direction], windVelocity);
+}
+
+void FireSpreadEngine::setNeighbourhood(Neighbourhood sneighbourhood) {
+	neighbourhood = sneighbourhood;
+	selectSpreadKernel();
+	updateIgnitionThresholds();
+	// the cells with only diagonal unburnt neighbours join or leave the front
+	frontOutdated = true;
+}
+
+void FireSpreadEngine::setVegetationType(VegetationType type) {
+	vegType = type;
+	if (terrain == &ownTerrain) {
+		ownTerrain.fillFuelModels(type);
+		// the events that are already scheduled were drawn with the previous fuel models
+		eventsOutdated = true;
+		updateBurnableBits();
+		countStatistics();
+	}
+}
+
+void FireSpreadEngine::setFuelModels(const unsigned char* models) {
+	if (terrain == &ownTerrain) {
+		ownTerrain.setFuelModels(models);
+		eventsOutdated = true;
+		updateBurnableBits();
+		countStatistics();
+	}
+}
+
+void FireSpreadEngine::setFuelModel(int x, int y, VegetationType type) {
+	if (terrain == &ownTerrain && isInside(x, y)) {
+		int index = y * cols + x;
+		// the edges of the front towards an unburnt cell are counted again with its new fuel
+		bool unburnt = state.get(index) == UNBURNT;
+		if (unburnt)
+			countStateChange(index, UNBURNT, PROTECTED);
+		ownTerrain.setFuelModel(index, type);
+		uint64_t bit = static_cast<uint64_t>(1) << (index & 63);
+		if (!terrain->isWater(index) && burnDurations[type] > 0)
+			burnableBits[index >> 6] |= bit;
+		else
+			burnableBits[index >> 6] &= ~bit;
+		if (unburnt)
+			countStateChange(index, PROTECTED, UNBURNT);
+		eventsOutdated = true;
+	}
+}
+
+void FireSpreadEngine::setStepMode(StepMode mode) {
+	stepMode = mode;
+}
+
+void FireSpreadEngine::setNumberOfThreads(int threads) {
+	threadPool.setNumberOfThreads(threads);
+	threadDraws.resize(threadPool.getNumberOfThreads());
+	for (size_t thread = 0; thread < threadDraws.size(); thread++) {
+		// a word adds at most 4 * 64 attempts to a batch
+		IgnitionDraws& draws = threadDraws[thread];
+		draws.counters.resize(drawBatch + FireTerrain::numberOfNeighbours * 64 + FireGridKernels::paddingDraws);
+		draws.thresholds.resize(draws.counters.size());
+		draws.ignitions.resize(draws.counters.size());
+	}
+}
+
+bool FireSpreadEngine::ignite(int x, int y) {
+	if (!isInside(x, y) || state.get(y * cols + x) != UNBURNT)
+		return false;
+	int index = y * cols + x;
+	int duration = burnDurations[terrain->getFuelModel(index)];
+	if (duration == 0)
+		return false;
+	countStateChange(index, UNBURNT, BURNING);
+	state.set(index, BURNING);
+	fuel[index] = static_cast<unsigned char>(duration);
+	burningCells++;
+	changedCells.push_back(index);
+	// the fire burns from this time step: the front and the burnout wheel are filled again from the fuel
+	frontOutdated = true;
+	burningWordsOutdated = true;
+	eventsOutdated = true;
+	return true;
+}
+
+void FireSpreadEngine::protect(int x, int y) {
+	if (!isInside(x, y))
+		return;
+	int index = y * cols + x;
+	int previous = state.get(index);
+	if (previous == PROTECTED)
+		return;
+	if (previous == BURNING) {
+		fuel[index] = 0;
+		burningCells--;
+	}
+	countStateChange(index, previous, PROTECTED);
+	state.set(index, PROTECTED);
+	// a burning or extinguished cell is drawn again (it does not burn out any more)
+	changedCells.push_back(index);
+}
+
+/***
+One time step of the model:
+	- every burning cell tries to set its unburnt neighbours on fire
+	- every burning cell uses one unit of fuel and is extinguished when it has none left
+	- the new fires start spreading at the next time step
+In AUTOMATIC_STEP mode the front step is only used for small fires, the grid step has a fixed cost
+that depends on the size of the raster.
+***/
+void FireSpreadEngine::step() {
+	bool useGrid = stepMode == GRID_STEP ||
+		(stepMode == AUTOMATIC_STEP && burningCells * gridStepWordsPerCell >= state.getNumberOfWords());
+	int frontBefore = frontEdges;
+	int burntBefore = getNumberOfBurntCells();
+
+	random.setKeys(seed, tick);
+	if (stepMode == EVENT_STEP) {
+		if (eventsOutdated)
+			rebuildEvents();
+		stepEvents();
+		frontOutdated = true;
+		burningWordsOutdated = true;
+	}
+	else {
+		eventsOutdated = true;
+		if (useGrid) {
+			if (fuelOutdated)
+				updateFuelFromWheel();
+			stepGrid();
+		}
+		else {
+			if (frontOutdated)
+				rebuildFront();
+			stepFront();
+			burningWordsOutdated = true;
+		}
+	}
+	tick++;
+
+	// the burnt cells only increase during a time step
+	ignitedCells = getNumberOfBurntCells() - burntBefore;
+	rateOfSpread = frontBefore > 0 ? static_cast<float>(ignitedCells) / frontBefore : 0;
+}
+
+// Front step: only visits the cells of the active front and the cells that burn out in this time step
+void FireSpreadEngine::stepFront() {
+	const std::vector<int>& burning = front[currentFront];
+	std::vector<int>& nextFront = front[1 - currentFront];
+	nextFront.clear();
+
+	for (size_t i = 0; i < burning.size(); i++) {
+		int index = burning[i];
+
+		// the cell may have been protected by a House With Barrier in the meantime
+		if (!state.isBurning(index))
+			continue;
+
+		// the cells that burn out in this time step leave the front at the next one
+		if ((this->*spreadKernel)(index, nextFront) > 0)
+			nextFront.push_back(index);
+	}
+	currentFront = 1 - currentFront;
+	burnOut();
+}
+
+// Rebuilds the active front from the state raster and the burnout wheel from the fuel (after other steps or ignitions)
+void FireSpreadEngine::rebuildFront() {
+	if (fuelOutdated)
+		updateFuelFromWheel();
+	clearEvents();
+	std::vector<int>& burning = front[currentFront];
+	burning.clear();
+
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		uint64_t bits = low[w] & ~high[w];
+		while (bits) {
+			int index = 64 * w + FireStateRaster::lowestBit(bits);
+			bits &= bits - 1;
+
+			// unburnt neighbours (land or water) keep the cell in the front
+			int x = index % cols;
+			int y = index / cols;
+			bool unburntNeighbour = false;
+			for (int n = 0; n < getNumberOfNeighbours() && !unburntNeighbour; n++) {
+				int newX = x + FireTerrain::offsetX(n);
+				int newY = y + FireTerrain::offsetY(n);
+				unburntNeighbour = isInside(newX, newY) && state.isUnburnt(newY * cols + newX);
+			}
+			if (unburntNeighbour)
+				burning.push_back(index);
+			burnoutWheel[(tick + fuel[index] - 1) % eventBuckets].push_back(index);
+		}
+	}
+	frontOutdated = false;
+	fuelOutdated = true;
+}
+
+// Extinguishes the cells of the burnout wheel that burn out in this time step
+void FireSpreadEngine::burnOut() {
+	std::vector<int>& burnouts = burnoutWheel[tick % eventBuckets];
+	for (size_t i = 0; i < burnouts.size(); i++) {
+		int index = burnouts[i];
+		// the cell may have been protected by a House With Barrier in the meantime
+		if (state.isBurning(index)) {
+			// redraw the cell when it is extinguished
+			countStateChange(index, BURNING, EXTINGUISHED);
+			state.set(index, EXTINGUISHED);
+			burningCells--;
+			changedCells.push_back(index);
+		}
+	}
+	burnouts.clear();
+}
+
+// Sets a cell on fire from the next time step and adds it to the given front
+void FireSpreadEngine::addNewFire(int index, std::vector<int>& nextFront) {
+	countStateChange(index, UNBURNT, BURNING);
+	state.set(index, BURNING);
+	burningCells++;
+	nextFront.push_back(index);
+	changedCells.push_back(index);
+	burnoutWheel[(tick + burnDurations[terrain->getFuelModel(index)]) % eventBuckets].push_back(index);
+}
+
+/***
+Statistics of a change of state, before the state raster is changed: the edges of the active front between the cell
+and its neighbours are counted again with its new state
+***/
+void FireSpreadEngine::countStateChange(int index, int oldState, int newState) {
+	if (oldState == EXTINGUISHED)
+		extinguishedCells--;
+	if (newState == EXTINGUISHED)
+		extinguishedCells++;
+
+	int burning, unburnt;
+	countNeighbours(index, burning, unburnt);
+	int burnable = static_cast<int>((burnableBits[index >> 6] >> (index & 63)) & 1);
+	frontEdges += ((newState == BURNING) - (oldState == BURNING)) * unburnt +
+		((newState == UNBURNT) - (oldState == UNBURNT)) * burnable * burning;
+}
+
+// Adds a cell to the burning cells or the unburnt cells that can catch fire, if valid (0 or 1)
+static inline void countNeighbour(const uint64_t* low, const uint64_t* high, const uint64_t* burnable, int index, int valid, int& burning, int& unburnt) {
+	int w = index >> 6;
+	int bit = index & 63;
+	int lowBit = static_cast<int>((low[w] >> bit) & 1);
+	int highBit = static_cast<int>((high[w] >> bit) & 1);
+	burning += valid & lowBit & ~highBit;
+	unburnt += valid & ~(lowBit | highBit) & static_cast<int>((burnable[w] >> bit) & 1);
+}
+
+// Burning neighbours and unburnt neighbours that can catch fire of a cell, read from the bit rasters only.
+// Only the four neighbours sharing a side are counted, whatever the neighbourhood (the front is a length of sides).
+// The neighbours outside the raster are replaced by the cell itself and not counted, without branches.
+inline void FireSpreadEngine::countNeighbours(int index, int& burning, int& unburnt) const {
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	const uint64_t* burnable = burnableBits.data();
+	int w = index >> 6;
+	int bit = index & 63;
+	int left = static_cast<int>(((state.getFirstColumnBits()[w] >> bit) & 1) ^ 1);
+	int right = static_cast<int>(((state.getLastColumnBits()[w] >> bit) & 1) ^ 1);
+	int up = index >= cols;
+	int down = index < cols * (rows - 1);
+
+	burning = 0;
+	unburnt = 0;
+	countNeighbour(low, high, burnable, index - left, left, burning, unburnt);
+	countNeighbour(low, high, burnable, index + right, right, burning, unburnt);
+	countNeighbour(low, high, burnable, up ? index - cols : index, up, burning, unburnt);
+	countNeighbour(low, high, burnable, down ? index + cols : index, down, burning, unburnt);
+}
+
+// Counts the statistics again from the state raster (after restores and changes of the terrain)
+void FireSpreadEngine::countStatistics() {
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	extinguishedCells = 0;
+	frontEdges = 0;
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		extinguishedCells += FireStateRaster::countBits(high[w] & ~low[w]);
+		for (uint64_t bits = low[w] & ~high[w]; bits; bits &= bits - 1) {
+			int burning, unburnt;
+			countNeighbours(64 * w + FireStateRaster::lowestBit(bits), burning, unburnt);
+			frontEdges += unburnt;
+		}
+	}
+	ignitedCells = 0;
+	rateOfSpread = 0;
+}
+
+// Unburnt neighbours of the burning cells of an area (clamped to the raster), see countStatistics()
+int FireSpreadEngine::countFrontEdges(int firstX, int firstY, int lastX, int lastY) const {
+	int edges = 0;
+	for (int y = std::max(firstY, 0); y < std::min(lastY, rows); y++) {
+		for (int index = y * cols + std::max(firstX, 0); index < y * cols + std::min(lastX, cols); index++) {
+			if (state.isBurning(index)) {
+				int burning, unburnt;
+				countNeighbours(index, burning, unburnt);
+				edges += unburnt;
+			}
+		}
+	}
+	return edges;
+}
+
+// Cells that can catch fire: on land, with a fuel model that burns (after changes of the terrain)
+void FireSpreadEngine::updateBurnableBits() {
+	const uint64_t* land = terrain->getLandBits();
+	burnableBits.assign(state.getNumberOfWords(), 0);
+	for (int index = 0; index < cols * rows; index++) {
+		if (burnDurations[terrain->getFuelModel(index)] > 0)
+			burnableBits[index >> 6] |= static_cast<uint64_t>(1) << (index & 63);
+	}
+	for (int w = 0; w < state.getNumberOfWords(); w++)
+		burnableBits[w] &= land[w];
+}
+
+/***
+PROBABILITIES FOR FIRE SPREAD BASED ON WIND AND SLOPE
+Reference:
+A Qualitative comparison of fire spread models incorporating wind and slope effects,
+Weise and Biging,
+Forest Science 43.2 (1997): 170 - 180
+Indexed by direction of the neighbour with respect to the wind, FireTerrain::SlopeBand and WindSpeed
+	- heading direction: wind supports fire spread
+	- backing direction: wind doesnt support fire spread
+	- perpendicular to wind direction: no wind effects
+***/
+enum WindRelativeDirection {
+	HEADING = 0,
+	BACKING = 1,
+	PERPENDICULAR = 2
+};
+
+static constexpr float windAndSlopeProbability[3][FireTerrain::numberOfSlopeBands][3] = {
+	// heading: NoWind, LowWind, HighWind
+	{ { 2.55f, 8.24f, 36.96f },		// slope <= -30
+	{ 5.4f, 7.1f, 33.4f },			// -30 < slope <= -15
+	{ 4.9f, 9.9f, 42.0f },			// -15 < slope < 0
+	{ 5.26f, 15.6f, 63.6f },		// 0 <= slope <= 15
+	{ 6.10f, 18.42f, 76.63f },		// 15 < slope <= 30
+	{ 23.32f, 23.32f, 100 } },		// slope > 30
+	// backing
+	{ { 2.55f, 2.3f, 2.6f },
+	{ 5.4f, 2.7f, 1.6f },
+	{ 4.9f, 3.2f, 2.02f },
+	{ 5.26f, 4.7f, 2.22f },
+	{ 6.10f, 5.5f, 2.0f },
+	{ 23.32f, 18.3f, 1.1f } },
+	// perpendicular
+	{ { 2.55f, 2.55f, 2.55f },
+	{ 5.4f, 5.4f, 5.4f },
+	{ 4.9f, 4.9f, 4.9f },
+	{ 5.26f, 5.26f, 5.26f },
+	{ 6.10f, 6.10f, 6.10f },
+	{ 23.32f, 23.32f, 23.32f } }
+};
+
+/***
+MULTIPYING FACTORS FOR FIRE SPREAD BASED ON VEGETATION TYPE
+Reference:
+Chapter 4 - "Fire hazard and flammability of European forest types" in the book "Post-fire management and restoration of southern European forests".
+Xanthopoulos, Gavriil, Carlo Calfapietra, and Paulo Fernandes,
+Springer Netherlands (2012): 79-92.
+Indexed by VegetationType (fuel model of the cell the fire spreads to): Evergreen, Grassland, Pinus, Non burnable
+***/
+static constexpr double vegetationFactor[FireSpreadEngine::numberOfFuelModels] = { 1, 1.4, 1.8, 0 };
+
+
+/***
+Probability (in percent) for a burning cell to set its neighbour on fire, with the wind, slope and vegetation effects.
+The table only has the neighbours heading, backing and perpendicular to the wind and three wind speeds: for any
+wind, the probability is interpolated linearly between the wind speeds (velocity clamped to the highest one), then
+between the heading (or backing) and the perpendicular values by the cosine of the angle between the wind and the
+direction of the spread. The dropdown options give the values of the table.
+The diagonal neighbours are sqrt(2) times further away: their probability is scaled so that the mean number of
+time steps before the fire reaches them is sqrt(2) times longer, 1 - (1 - p)^(1 / sqrt(2)) (see updateIgnitionThresholds()).
+***/
+static double windAndSlopeEffect(double cosine, float velocity, int slopeBand) {
+	int column = velocity < windVelocities[1] ? 0 : 1;
+	double t = std::min((velocity - windVelocities[column]) / (windVelocities[column + 1] - windVelocities[column]), 1.0f);
+	double values[3];
+	for (int direction = 0; direction < 3; direction++) {
+		const float* speeds = windAndSlopeProbability[direction][slopeBand];
+		values[direction] = (1 - t) * speeds[column] + t * speeds[column + 1];
+	}
+	if (cosine >= 0)
+		return cosine * values[HEADING] + (1 - cosine) * values[PERPENDICULAR];
+	return -cosine * values[BACKING] + (1 + cosine) * values[PERPENDICULAR];
+}
+
+/***
+Probability (percent) scaled to a 15 bit integer, minus one so that it fits in 16 bits: the fire spreads if
+the random number of the attempt (FireRandom::draw15(), 0 - 32767) is below or equal to the threshold.
+Every step uses these thresholds and the same random numbers, so they give the same fire.
+***/
+static int ignitionThreshold(float probability) {
+	return std::min(static_cast<int>(probability * 327.68f + 0.5f), 32768) - 1;
+}
+
+/***
+SPREAD FIRE FUNCTION:
+	- Considers the four (or eight) neighbours of a burning cell
+	- Creates new fires on the unburnt cells on land depending on probabilities
+	- Returns the number of neighbours that are still unburnt
+One instantiation per neighbourhood: the probabilities are read from ignitionThresholds, indexed by the fuel model
+and the slope band of the neighbour and rebuilt when the wind changes, and the neighbours are unrolled, so the loop
+over the front does not branch on the parameters and a mixed landscape costs the same as a uniform one.
+***/
+template <int neighbours>
+int FireSpreadEngine::spreadFireKernel(int index, std::vector<int>& nextFront) {
+	int current_x = index % cols;
+	int current_y = index / cols;
+	bool left = current_x > 0;
+	bool right = current_x < cols - 1;
+	bool up = current_y > 0;
+	bool down = current_y < rows - 1;
+
+	// cells outside the sandbox can never catch fire
+	int unburntNeighbours = 0;
+	if (left)
+		unburntNeighbours += spreadToNeighbour<FireTerrain::LEFT>(index, index - 1, nextFront);
+	if (right)
+		unburntNeighbours += spreadToNeighbour<FireTerrain::RIGHT>(index, index + 1, nextFront);
+	if (up)
+		unburntNeighbours += spreadToNeighbour<FireTerrain::UP>(index, index - cols, nextFront);
+	if (down)
+		unburntNeighbours += spreadToNeighbour<FireTerrain::DOWN>(index, index + cols, nextFront);
+	if (neighbours == 8) {
+		if (up && left)
+			unburntNeighbours += spreadToNeighbour<FireTerrain::UP_LEFT>(index, index - cols - 1, nextFront);
+		if (down && right)
+			unburntNeighbours += spreadToNeighbour<FireTerrain::DOWN_RIGHT>(index, index + cols + 1, nextFront);
+		if (up && right)
+			unburntNeighbours += spreadToNeighbour<FireTerrain::UP_RIGHT>(index, index - cols + 1, nextFront);
+		if (down && left)
+			unburntNeighbours += spreadToNeighbour<FireTerrain::DOWN_LEFT>(index, index + cols - 1, nextFront);
+	}
+	return unburntNeighbours;
+}
+
+// Tries to set one neighbour on fire, returns 1 if the neighbour is still unburnt afterwards
+template <int neighbour>
+inline int FireSpreadEngine::spreadToNeighbour(int index, int newIndex, std::vector<int>& nextFront) {
+	// only unburnt cells can catch fire
+	if (!state.isUnburnt(newIndex))
+		return 0;
+
+	// check if the new cell is inside/outside water (water may become land when the sand is reshaped)
+	if (terrain->isWater(newIndex))
+		return 1;
+
+	// Apply slope, wind and vegetation effects: the slope band towards the new cell is precomputed with the elevation
+	// The random number only depends on the new cell and the direction the fire comes from (see FireRandom)
+	const int from = FireTerrain::opposite(neighbour);
+	uint32_t counter = FireRandom::counter(newIndex, from);
+	if (static_cast<int>(random.draw15(counter)) <= ignitionThresholds[terrain->getFuelModel(newIndex)][from][terrain->getSlopeBand(neighbour, index)]) {
+		addNewFire(newIndex, nextFront);
+		return 0;
+	}
+	return 1;
+}
+
+// Picks the spread kernel of the current neighbourhood
+void FireSpreadEngine::selectSpreadKernel() {
+	spreadKernel = neighbourhood == MOORE ? &FireSpreadEngine::spreadFireKernel<8> : &FireSpreadEngine::spreadFireKernel<4>;
+}
+
+/***
+EVENT STEP:
+A burning cell tries to set each unburnt neighbour on fire at every time step until it is extinguished, with the
+same probability p every time: the number of time steps before the fire spreads to the neighbour follows a
+geometric distribution, drawn once when the cell catches fire (inverse transform of a uniform random number):
+	delay = 1 + floor(log(u) / log(1 - p))
+If the delay is longer than the time the cell burns, the fire never spreads to that neighbour. The time step
+only pops the events that are due: the fires that spread (if the source still burns and the cell is still unburnt
+on land) and the cells that burn out. The slope of a spread is the one when the source caught fire; the events
+are drawn again when the model parameters change.
+***/
+void FireSpreadEngine::stepEvents() {
+	// the new fires only schedule events in the next time steps, never in this bucket
+	std::vector<std::pair<int, int> >& spreads = spreadEvents[tick % eventBuckets];
+	for (size_t i = 0; i < spreads.size(); i++) {
+		int index = spreads[i].first;
+		// the source may have been protected by a House With Barrier in the meantime
+		if (state.isBurning(spreads[i].second) && state.isUnburnt(index) && !terrain->isWater(index)) {
+			countStateChange(index, UNBURNT, BURNING);
+			state.set(index, BURNING);
+			burningCells++;
+			changedCells.push_back(index);
+			scheduleFire(index, tick + 1, burnDurations[terrain->getFuelModel(index)]);
+		}
+	}
+	spreads.clear();
+	burnOut();
+}
+
+// Schedules the spreads of a burning cell that tries to set its neighbours on fire from the time step firstTick
+// during attempts time steps, and its burnout at the end of the last one
+void FireSpreadEngine::scheduleFire(int index, unsigned int firstTick, int attempts) {
+	// the uniform random numbers only depend on the seed, the time step, the cell and the direction
+	FireRandom draws;
+	draws.setKeys(seed, firstTick);
+	int x = index % cols;
+	int y = index / cols;
+	for (int n = 0; n < getNumberOfNeighbours(); n++) {
+		if (!isInside(x + FireTerrain::offsetX(n), y + FireTerrain::offsetY(n)))
+			continue;
+		int newIndex = index + FireTerrain::offsetY(n) * cols + FireTerrain::offsetX(n);
+		if (!state.isUnburnt(newIndex))
+			continue;
+
+		int from = FireTerrain::opposite(n);
+		float logMiss = ignitionLogMisses[terrain->getFuelModel(newIndex)][from][terrain->getSlopeBand(n, index)];
+		if (logMiss >= 0)
+			continue;	// probability 0
+		double u = (draws.draw32(FireRandom::counter(newIndex, from)) + 0.5) / 4294967296.0;
+		double delay = 1 + std::floor(std::log(u) / logMiss);
+		if (delay <= attempts)
+			spreadEvents[(firstTick + static_cast<unsigned int>(delay) - 1) % eventBuckets].push_back(std::make_pair(newIndex, index));
+	}
+	burnoutWheel[(firstTick + attempts - 1) % eventBuckets].push_back(index);
+}
+
+// Schedules the events of every burning cell from its fuel (after other steps or ignitions)
+void FireSpreadEngine::rebuildEvents() {
+	if (fuelOutdated)
+		updateFuelFromWheel();
+	clearEvents();
+
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	for (int w = 0; w < state.getNumberOfWords(); w++) {
+		for (uint64_t bits = low[w] & ~high[w]; bits; bits &= bits - 1) {
+			int index = 64 * w + FireStateRaster::lowestBit(bits);
+			scheduleFire(index, tick, fuel[index]);
+		}
+	}
+	eventsOutdated = false;
+	fuelOutdated = true;
+}
+
+// Fuel of the burning cells from the burnout wheel (before grid steps and rebuilds)
+void FireSpreadEngine::updateFuelFromWheel() {
+	for (int ahead = 0; ahead < eventBuckets; ahead++) {
+		const std::vector<int>& burnouts = burnoutWheel[(tick + ahead) % eventBuckets];
+		for (size_t i = 0; i < burnouts.size(); i++) {
+			if (state.isBurning(burnouts[i]))
+				fuel[burnouts[i]] = static_cast<unsigned char>(ahead + 1);
+		}
+	}
+	clearEvents();
+	fuelOutdated = false;
+}
+
+void FireSpreadEngine::clearEvents() {
+	for (int bucket = 0; bucket < eventBuckets; bucket++) {
+		spreadEvents[bucket].clear();
+		burnoutWheel[bucket].clear();
+	}
+}
+
+/***
+GRID STEP:
+Cellular automaton on the packed state raster, 64 cells (one word of the bit planes) at a time
+	- the cells that can catch fire are the unburnt cells on land with a burning neighbour, found with
+	  shifts of the burning bits (left/right: 1 bit, up/down: one row of cols bits)
+	- FireGridKernels::ignite() draws the random numbers of the candidates and compares them with the
+	  ignition thresholds of the cells, FireGridKernels::burn() burns the fuel of the burning cells
+Only the words with burning cells and the words next to them are visited, the list of the burning words
+is kept up to date from one grid step to the next.
+The spread and the burn are split in tiles of tileWords words run by the threads of threadPool: a tile only
+writes to its own words, and the lists of the tiles are merged in order, so the result does not depend on
+the number of threads.
+The random number of every attempt only depends on the seed, the time step, the cell and the neighbour
+the fire comes from, so the result does not depend on the instruction set, nor on the step used.
+***/
+void FireSpreadEngine::stepGrid() {
+	frontOutdated = true;
+
+	uint64_t* low = state.getLowBits();
+	uint64_t* high = state.getHighBits();
+	const int words = state.getNumberOfWords();
+	const int rowWords = cols >> 6;
+
+	if (burningWordsOutdated) {
+		burningWords.clear();
+		for (int w = 0; w < words; w++) {
+			if (low[w] & ~high[w])
+				burningWords.push_back(w);
+		}
+		burningWordsOutdated = false;
+	}
+	if (burningWords.empty())
+		return;
+
+	// burning cells at the beginning of the time step, the zero words around avoid bound checks
+	// words to visit: the burning words and the words next to them (left, right, one row up and down, which also
+	// holds the diagonal neighbours)
+	uint64_t* burning = burningBits.data() + rowWords + 2;
+	unsigned char* visit = visitWords.data();
+	for (size_t i = 0; i < burningWords.size(); i++) {
+		int w = burningWords[i];
+		burning[w] = low[w] & ~high[w];
+		visit[std::max(w - rowWords - 1, 0)] = 1;
+		visit[std::max(w - rowWords, 0)] = 1;
+		visit[std::max(w - 1, 0)] = 1;
+		visit[w] = 1;
+		visit[std::min(w + 1, words - 1)] = 1;
+		visit[std::min(w + rowWords, words - 1)] = 1;
+		visit[std::min(w + rowWords + 1, words - 1)] = 1;
+	}
+
+	// spread the fire, one task per tile of tileWords words
+	// the new fires start burning at the end of the time step
+	const int tiles = (words + tileWords - 1) / tileWords;
+	runGridTasks(tiles, [this](int tile, int thread) {
+		if (neighbourhood == MOORE)
+			spreadGridTile<8>(tile, thread);
+		else
+			spreadGridTile<4>(tile, thread);
+	});
+	ignitedWords.clear();
+	for (int tile = 0; tile < tiles; tile++)
+		ignitedWords.insert(ignitedWords.end(), tileIgnitedWords[tile].begin(), tileIgnitedWords[tile].end());
+
+	// burn the fuel of the cells that were burning at the beginning of the time step, tileWords words per task
+	const int burningTiles = (static_cast<int>(burningWords.size()) + tileWords - 1) / tileWords;
+	runGridTasks(burningTiles, [this, burning](int tile, int) {
+		int first = tile * tileWords;
+		int count = std::min(static_cast<int>(burningWords.size()) - first, +tileWords);
+		gridKernels.burn(fuel.data(), burning, burningWords.data() + first, count, extinguishedBits.data() + first);
+	});
+	size_t kept = 0;
+	for (size_t i = 0; i < burningWords.size(); i++) {
+		int w = burningWords[i];
+		uint64_t extinguished = extinguishedBits[i];
+		burning[w] = 0;
+		low[w] &= ~extinguished;
+		high[w] |= extinguished;
+		while (extinguished) {
+			// the other cells extinguished in this word do not change the front of this one
+			int index = 64 * w + FireStateRaster::lowestBit(extinguished);
+			extinguished &= extinguished - 1;
+			countStateChange(index, BURNING, EXTINGUISHED);
+			changedCells.push_back(index);
+			burningCells--;
+		}
+		if (low[w] & ~high[w])
+			burningWords[kept++] = w;
+	}
+	burningWords.resize(kept);
+
+	// new fires
+	for (size_t i = 0; i < ignitedWords.size(); i++) {
+		int w = ignitedWords[i];
+		uint64_t ignitions = ignitionBits[w];
+		ignitionBits[w] = 0;
+		while (ignitions) {
+			// one cell at a time, the statistics read the state of the neighbours
+			int bit = FireStateRaster::lowestBit(ignitions);
+			int index = 64 * w + bit;
+			ignitions &= ignitions - 1;
+			countStateChange(index, UNBURNT, BURNING);
+			low[w] |= static_cast<uint64_t>(1) << bit;
+			fuel[index] = static_cast<unsigned char>(burnDurations[terrain->getFuelModel(index)]);
+			changedCells.push_back(index);
+			burningCells++;
+		}
+	}
+
+	// both lists are sorted
+	nextBurningWords.clear();
+	std::set_union(burningWords.begin(), burningWords.end(), ignitedWords.begin(), ignitedWords.end(), std::back_inserter(nextBurningWords));
+	burningWords.swap(nextBurningWords);
+}
+
+// Bits of the cells index + offset for the 64 cells of word w (the words read must exist)
+static inline uint64_t shiftedBits(const uint64_t* bits, int w, int offset) {
+	int first = w + (offset >> 6);
+	int shift = offset & 63;
+	return shift ? (bits[first] >> shift) | (bits[first + 1] << (64 - shift)) : bits[first];
+}
+
+/***
+Spread of the grid step in a tile of tileWords words (the tiles are independent, see stepGrid()):
+the ignition attempts of the visited words are collected and drawn in batches, the words with new fires
+are listed in tileIgnitedWords[tile] (in order). thread: index of the thread running the tile (for its buffers)
+One instantiation per neighbourhood (4 or 8 neighbours).
+***/
+template <int neighbours>
+void FireSpreadEngine::spreadGridTile(int tile, int thread) {
+	const uint64_t* low = state.getLowBits();
+	const uint64_t* high = state.getHighBits();
+	const uint64_t* land = terrain->getLandBits();
+	const uint64_t* firstColumn = state.getFirstColumnBits();
+	const uint64_t* lastColumn = state.getLastColumnBits();
+	const int words = state.getNumberOfWords();
+	const int rowWords = cols >> 6;
+	const int rowBits = cols & 63;
+	const uint64_t* burning = burningBits.data() + rowWords + 2;
+	unsigned char* visit = visitWords.data();
+
+	// slope bands of the neighbour n towards the cell, the packed index of the neighbour is clamped to the raster
+	// since every neighbour is read (its attempt is only kept if it is burning)
+	const unsigned char* fuelModels = terrain->getFuelModels();
+	const unsigned char* slopeBands[neighbours];
+	int offsets[neighbours];
+	for (int n = 0; n < neighbours; n++) {
+		slopeBands[n] = terrain->getSlopeBands(FireTerrain::opposite(n));
+		offsets[n] = FireTerrain::offsetY(n) * cols + FireTerrain::offsetX(n);
+	}
+	const int lastCell = cols * rows - 1;
+	IgnitionDraws& draws = threadDraws[thread];
+	uint32_t* counters = draws.counters.data();
+	int32_t* thresholds = draws.thresholds.data();
+	std::vector<int>& ignited = tileIgnitedWords[tile];
+	ignited.clear();
+	int count = 0;
+	for (int v = tile * tileWords; v < std::min((tile + 1) * tileWords, words); v += 8) {
+		// 8 words at a time, most of the raster is not visited
+		uint64_t visitEight;
+		std::memcpy(&visitEight, visit + v, sizeof(visitEight));
+		if (visitEight == 0)
+			continue;
+
+		for (int w = v; w < v + 8; w++) {
+			if (!visit[w])
+				continue;
+			visit[w] = 0;
+
+			uint64_t up = burning[w - rowWords];
+			uint64_t down = burning[w + rowWords];
+			if (rowBits) {
+				up = (up << rowBits) | (burning[w - rowWords - 1] >> (64 - rowBits));
+				down = (down >> rowBits) | (burning[w + rowWords + 1] << (64 - rowBits));
+			}
+			uint64_t left = ((burning[w] << 1) | (burning[w - 1] >> 63)) & ~firstColumn[w];
+			uint64_t right = ((burning[w] >> 1) | (burning[w + 1] << 63)) & ~lastColumn[w];
+			uint64_t unburnt = ~(low[w] | high[w]) & land[w];
+
+			uint64_t neighbourBurning[neighbours];
+			neighbourBurning[FireTerrain::LEFT] = left & unburnt;
+			neighbourBurning[FireTerrain::RIGHT] = right & unburnt;
+			neighbourBurning[FireTerrain::UP] = up & unburnt;
+			neighbourBurning[FireTerrain::DOWN] = down & unburnt;
+			uint64_t anyBurning = left | right | up | down;
+			for (int n = 4; n < neighbours; n++) {
+				// the neighbours at x - 1 do not exist in the first column, the ones at x + 1 in the last one
+				uint64_t column = FireTerrain::offsetX(n) < 0 ? firstColumn[w] : lastColumn[w];
+				uint64_t diagonal = shiftedBits(burning, w, offsets[n]) & ~column;
+				neighbourBurning[n] = diagonal & unburnt;
+				anyBurning |= diagonal;
+			}
+
+			// one attempt per burning neighbour of the cells, without branches on the neighbours
+			uint64_t cells = anyBurning & unburnt;
+			while (cells) {
+				int bit = FireStateRaster::lowestBit(cells);
+				cells &= cells - 1;
+				uint32_t index = 64 * w + bit;
+				const int16_t (*cellThresholds)[FireTerrain::numberOfSlopeBands] = ignitionThresholds[fuelModels[index]];
+				for (int n = 0; n < neighbours; n++) {
+					counters[count] = FireRandom::counter(index, n);
+					int from = std::min(std::max(static_cast<int>(index) + offsets[n], 0), lastCell);
+					thresholds[count] = cellThresholds[n][slopeBands[n][from]];
+					count += static_cast<int>((neighbourBurning[n] >> bit) & 1);
+				}
+			}
+			if (count >= drawBatch) {
+				igniteDraws(draws, count, ignited);
+				count = 0;
+			}
+		}
+	}
+	igniteDraws(draws, count, ignited);
+
+}
+
+// Draws the collected ignition attempts, the words with new fires are appended to ignited (in order)
+void FireSpreadEngine::igniteDraws(IgnitionDraws& draws, int count, std::vector<int>& ignited) {
+	int successes = gridKernels.ignite(draws.counters.data(), draws.thresholds.data(), count, random, draws.ignitions.data());
+	for (int i = 0; i < successes; i++) {
+		uint32_t index = FireRandom::cell(draws.ignitions[i]);
+		int w = static_cast<int>(index >> 6);
+		if (ignitionBits[w] == 0)
+			ignited.push_back(w);
+		ignitionBits[w] |= static_cast<uint64_t>(1) << (index & 63);
+	}
+}
+
+// Runs the tasks of the grid step on the threads, or on the calling thread when the fire is small
+void FireSpreadEngine::runGridTasks(int tasks, const FireThreadPool::Task& task) {
+	if (static_cast<int>(burningWords.size()) >= parallelGridWords) {
+		threadPool.run(tasks, task);
+	}
+	else {
+		for (int i = 0; i < tasks; i++)
+			task(i, 0);
+	}
+}
+
+/***
+Ignition thresholds: probability for a cell to catch fire from its neighbour n, which is the probability for that
+neighbour to spread the fire towards the opposite direction, for each fuel model of the cell and slope band.
+The spread towards a neighbour depends on the cosine between the wind and the direction of the neighbour (see
+windAndSlopeEffect()), snapped to 0 and +-1 so that the dropdown options give the values of the table.
+The probability towards a diagonal neighbour p is scaled to 1 - (1 - p)^(1 / sqrt(2)): its number of time steps
+before spreading (geometric distribution) is sqrt(2) times longer, like its distance.
+***/
+void FireSpreadEngine::updateIgnitionThresholds() {
+	const double radians = windAngle * 3.14159265358979323846 / 180;
+	const double windX = std::cos(radians);
+	const double windY = std::sin(radians);
+	for (int n = 0; n < FireTerrain::numberOfNeighbours; n++) {
+		// direction of the spread from the neighbour n towards the cell
+		int to = FireTerrain::opposite(n);
+		bool diagonal = FireTerrain::offsetX(to) != 0 && FireTerrain::offsetY(to) != 0;
+		double cosine = (windX * FireTerrain::offsetX(to) + windY * FireTerrain::offsetY(to)) / (diagonal ? std::sqrt(2.0) : 1.0);
+		if (std::fabs(cosine) < 1e-6)
+			cosine = 0;
+		else if (std::fabs(std::fabs(cosine) - 1) < 1e-6)
+			cosine = cosine > 0 ? 1 : -1;
+
+		for (int band = 0; band < FireTerrain::numberOfSlopeBands; band++) {
+			double effect = windAndSlopeEffect(cosine, windVelocity, band);
+			for (int model = 0; model < numberOfFuelModels; model++) {
+				float prob = static_cast<float>(effect * vegetationFactor[model]);
+				if (diagonal)
+					prob = prob >= 100 ? 100 : static_cast<float>(100 * (1 - std::pow(1 - prob / 100.0, 1 / std::sqrt(2.0))));
+				spreadProbabilities[model][to][band] = prob;
+				ignitionThresholds[model][n][band] = static_cast<int16_t>(ignitionThreshold(prob));
+				// same probability as the threshold, (threshold + 1) / 32768
+				ignitionLogMisses[model][n][band] = static_cast<float>(std::log(1 - (ignitionThresholds[model][n][band] + 1) / 32768.0));
+			}
+		}
+	}
+	// the events that are already scheduled were drawn with the previous probabilities
+	eventsOutdated = true;
+}
@@ -0,0 +1,410 @@
+/***********************************************************************
+FireSpreadEngine - headless version of the fire spread model of
+"Fire in the Sandbox". The engine works on a plain raster of cells
+(elevation in, cell states out) and does not depend on openFrameworks,
+the kinect or the GUI, so it can be benchmarked and run in isolation.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+Based on Magic Sand by Thomas Wolf (2016)
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "FireGridKernels.h"
+#include "FireRandom.h"
+#include "FireStateRaster.h"
+#include "FireThreadPool.h"
+#include "FireTerrain.h"
+
+class FireSpreadEngine {
+public:
+	/***
+	Cell states
+	0 - unburnt
+	1 - burning
+	2 - extinguished
+	3 - protected (House With Barrier)
+	***/
+	enum CellState {
+		UNBURNT = 0,
+		BURNING = 1,
+		EXTINGUISHED = 2,
+		PROTECTED = 3
+	};
+
+	// Model parameters (options of the GUI dropdowns, see setWind() for any wind)
+	enum WindSpeed {
+		NO_WIND = 0,
+		LOW_WIND = 1,	// Velocity = 0.42 m/s
+		HIGH_WIND = 2	// Velocity = 1.15 m/s
+	};
+	enum WindDirection {
+		WEST = 0,		// West to East
+		EAST = 1,		// East to West
+		SOUTH = 2,		// South to North
+		NORTH = 3		// North to South
+	};
+	// The vegetation types are also the fuel models of the cells (see setFuelModels())
+	enum VegetationType {
+		EVERGREEN = 0,
+		GRASSLAND = 1,
+		PINUS = 2,
+		NON_BURNABLE = 3	// firebreaks, roads, bare rock: painted cells that never burn
+	};
+	static const int numberOfFuelModels = 4;
+	// Neighbours a burning cell spreads to
+	enum Neighbourhood {
+		VON_NEUMANN = 0,	// the four neighbours sharing an edge (original model)
+		MOORE = 1			// the eight neighbours sharing an edge or a corner
+	};
+
+	/***
+	Implementations of the time step
+		- FRONT_STEP: visits the cells of the active front one by one, the cost depends on the length of the front
+		- GRID_STEP: evaluates the packed state raster 64 cells at a time and draws the random numbers with SIMD,
+		  the cost depends on the number of 64 cell words with burning cells, cheaper for large fires
+		- AUTOMATIC_STEP: picks the cheapest one of the front and grid steps at every time step
+		- EVENT_STEP: discrete-event scheduler, every new fire draws the time step at which it sets each of its
+		  neighbours on fire and the time step only processes the events that are due, the cost depends on the
+		  number of new fires. The probabilities are the same but the random draws are not: the fire is not the
+		  same as with the other steps
+	***/
+	enum StepMode {
+		FRONT_STEP = 0,
+		GRID_STEP = 1,
+		AUTOMATIC_STEP = 2,
+		EVENT_STEP = 3
+	};
+
+	FireSpreadEngine();
+
+	// Allocates a cols x rows raster; cellSize is the horizontal distance between two cells
+	// (in the same unit as the elevation) and is used to compute the slope
+	void setup(int cols, int rows, float cellSize);
+	// Allocates a raster on a terrain shared with other engines (FireEnsemble): the terrain is read in place and
+	// must not change while this engine steps, setElevation() is ignored
+	void setup(const FireTerrain& sharedTerrain);
+	// The random numbers are drawn from the seed, the time step and the cell (FireRandom): with the same seed,
+	// elevation, parameters and user actions, the fire is the same whatever the step mode and the number of threads
+	void setSeed(unsigned int seed);
+	unsigned int getSeed() const {
+		return seed;
+	}
+
+	// Clears every cell (including protected cells)
+	void reset();
+	// Removes the current fire (burning and extinguished cells) but keeps protected cells
+	void clearFire();
+
+	// Complete state of the model packed in getStateSize() words (time step and seed, state bit planes, fuel of the
+	// burning cells), to save a fire and restore it later on the same raster (FireHistory). The front, events and
+	// burnout wheel are rebuilt from it; restoreState() adds the cells whose state changed to the changed cells.
+	int getStateSize() const {
+		return 1 + 10 * state.getNumberOfWords();
+	}
+	void saveState(uint64_t* words) const;
+	void restoreState(const uint64_t* words);
+
+	// Elevation of every cell, row-major (cols * rows values). Cells below 0 are water.
+	// The slopes are computed here once, call it only when the elevation has changed (new depth frame).
+	void setElevation(const float* elevation);
+	// Elevation of the cells of an area only (see FireAdaptiveGrid), elevation is still the whole raster. The cost
+	// depends on the size of the area, the statistics are kept up to date without counting them again.
+	void setElevation(const float* elevation, int x, int y, int width, int height);
+	const FireTerrain& getTerrain() const {
+		return *terrain;
+	}
+
+	/***
+	Model parameters, the spread probabilities towards every neighbour are computed again when one of them changes
+	(see updateIgnitionThresholds()).
+	Wind: angle of the direction the wind blows towards in degrees (0: towards x + 1, 90: towards y + 1) and
+	velocity in m/s. setWindSpeed() and setWindDirection() set the velocity and the angle of the dropdown options.
+	***/
+	void setWind(float angle, float velocity);
+	void setWindSpeed(WindSpeed speed);
+	void setWindDirection(WindDirection direction);
+	float getWindAngle() const {
+		return windAngle;
+	}
+	float getWindVelocity() const {
+		return windVelocity;
+	}
+	void setNeighbourhood(Neighbourhood neighbourhood);
+	Neighbourhood getNeighbourhood() const {
+		return neighbourhood;
+	}
+	// 4 or 8, the neighbours FireTerrain::Neighbour 0 to getNumberOfNeighbours() - 1
+	int getNumberOfNeighbours() const {
+		return neighbourhood == MOORE ? 8 : 4;
+	}
+	// Gives the same fuel model to every cell (uniform vegetation)
+	void setVegetationType(VegetationType type);
+	// Fuel model given to every cell by the last call to setVegetationType()
+	VegetationType getVegetationType() const {
+		return vegType;
+	}
+	// Fuel model of every cell (VegetationType), row-major (cols * rows values), for mixed landscapes loaded from an
+	// image or painted. Stored in the terrain: ignored on a shared terrain, like setElevation(). The spread towards a
+	// cell uses the vegetation factor of its fuel model, and a cell burns for the burn duration of its fuel model.
+	void setFuelModels(const unsigned char* models);
+	void setFuelModel(int x, int y, VegetationType type);
+	VegetationType getFuelModel(int x, int y) const {
+		return isInside(x, y) ? static_cast<VegetationType>(terrain->getFuelModel(y * cols + x)) : NON_BURNABLE;
+	}
+	// Probability (percent) for a burning cell to set its neighbour (FireTerrain::Neighbour) on fire in a time step, for
+	// the slope band from the cell towards the neighbour and the fuel model of the neighbour, with the current wind
+	// (wind and slope effects, vegetation factor)
+	float getSpreadProbability(VegetationType type, int neighbour, int slopeBand) const {
+		return spreadProbabilities[type][neighbour][slopeBand];
+	}
+	// Number of time steps a cell of a fuel model burns (at most maximumBurnDuration, 0 if it never burns)
+	static int getBurnDuration(VegetationType type);
+
+	// Set a cell on fire, returns false if the cell cannot burn
+	bool ignite(int x, int y);
+	// Protect a cell from the fire (House With Barrier)
+	void protect(int x, int y);
+
+	// Run one time step of the model: spread the fire and burn the fuel of the burning cells
+	void step();
+	void setStepMode(StepMode mode);
+	// Instruction set of the grid step, returns false if the processor does not support it
+	bool setInstructionSet(FireGridKernels::InstructionSet set) {
+		return gridKernels.setInstructionSet(set);
+	}
+	FireGridKernels::InstructionSet getInstructionSet() const {
+		return gridKernels.getInstructionSet();
+	}
+	// Threads of the grid step (including the calling thread), all the cores of the processor by default
+	void setNumberOfThreads(int threads);
+	int getNumberOfThreads() const {
+		return threadPool.getNumberOfThreads();
+	}
+
+	// Getters
+	int getCols() const {
+		return cols;
+	}
+	int getRows() const {
+		return rows;
+	}
+	bool isInside(int x, int y) const {
+		return x >= 0 && x < cols && y >= 0 && y < rows;
+	}
+	int getCellState(int x, int y) const {
+		return isInside(x, y) ? state.get(y * cols + x) : UNBURNT;
+	}
+	int getCellState(int index) const {
+		return state.get(index);
+	}
+	// Time steps left to burn (only kept up to date by the grid step, the other steps use the burnout wheel)
+	int getFuel(int x, int y) const {
+		return isInside(x, y) ? fuel[y * cols + x] : 0;
+	}
+	const FireStateRaster& getStateRaster() const {
+		return state;
+	}
+
+	// Cells are referred to by their packed index y * cols + x
+	int getCellX(int index) const {
+		return index % cols;
+	}
+	int getCellY(int index) const {
+		return index / cols;
+	}
+
+	// Indices of the cells that caught fire, were extinguished or were protected since the last call to clearChangedCells()
+	const std::vector<int>& getChangedCells() const {
+		return changedCells;
+	}
+	void clearChangedCells() {
+		changedCells.clear();
+	}
+	int getNumberOfBurningCells() const {
+		return burningCells;
+	}
+
+	/***
+	Statistics of the fire, kept up to date at every change of state by the steps (no pass over the raster)
+		- burnt cells: cells that caught fire since the fire was cleared (burning and extinguished)
+		- front length: edges between burning cells and unburnt cells on land (in cells), the length of the active front
+		- rate of spread: cells that caught fire during the last time step per edge of the front at its beginning, the
+		  mean distance the front moved (cells per time step)
+	The front is measured in the shared sides of 4-connected cells in both neighbourhoods: with MOORE the fire also
+	crosses corners, but a corner has no length, so the cells ignited across one still count as a distance moved by
+	the sides of the front.
+	***/
+	int getNumberOfExtinguishedCells() const {
+		return extinguishedCells;
+	}
+	int getNumberOfBurntCells() const {
+		return burningCells + extinguishedCells;
+	}
+	int getFrontLength() const {
+		return frontEdges;
+	}
+	// Cells that caught fire during the last time step
+	int getNumberOfIgnitedCells() const {
+		return ignitedCells;
+	}
+	float getRateOfSpread() const {
+		return rateOfSpread;
+	}
+	// Time steps run since the fire was cleared
+	unsigned int getTick() const {
+		return tick;
+	}
+
+	static const int maximumBurnDuration = 50; // longest burn duration of the fuel models (at most 255)
+
+private:
+	void stepFront();
+	void stepGrid();
+	void rebuildFront();
+	void updateIgnitionThresholds();
+	void stepEvents();
+	void rebuildEvents();
+	void updateFuelFromWheel();
+	void clearEvents();
+	void scheduleFire(int index, unsigned int firstTick, int attempts);
+	// Buffers of the ignition attempts of one thread (see FireGridKernels::ignite())
+	struct IgnitionDraws {
+		std::vector<uint32_t> counters;
+		std::vector<int32_t> thresholds;
+		std::vector<uint32_t> ignitions;
+	};
+	void igniteDraws(IgnitionDraws& draws, int count, std::vector<int>& ignited);
+	void runGridTasks(int tasks, const FireThreadPool::Task& task);
+	// AUTOMATIC_STEP uses the grid step when there is at least one burning cell every gridStepWordsPerCell words
+	static const int gridStepWordsPerCell = 32;
+	// Ignition attempts drawn at once by the grid step
+	static const int drawBatch = 1024;
+	// Words per task of the grid step (a multiple of 8), and burning words from which the tasks are run by several threads
+	static const int tileWords = 256;
+	static const int parallelGridWords = 256;
+
+	// Spread kernel, specialized for each neighbourhood (see selectSpreadKernel())
+	typedef int (FireSpreadEngine::*SpreadKernel)(int index, std::vector<int>& nextFront);
+	template <int neighbours>
+	int spreadFireKernel(int index, std::vector<int>& nextFront);
+	template <int neighbour>
+	int spreadToNeighbour(int index, int newIndex, std::vector<int>& nextFront);
+	template <int neighbours>
+	void spreadGridTile(int tile, int thread);
+	void selectSpreadKernel();
+	void burnOut();
+	void addNewFire(int index, std::vector<int>& nextFront);
+	void countStateChange(int index, int oldState, int newState);
+	void countNeighbours(int index, int& burning, int& unburnt) const;
+	void countStatistics();
+	int countFrontEdges(int firstX, int firstY, int lastX, int lastY) const;
+	void updateBurnableBits();
+
+	// Raster
+	int cols, rows;
+	FireStateRaster state;
+	std::vector<unsigned char> fuel;	// 0 for the cells that are not burning
+	FireTerrain ownTerrain;
+	const FireTerrain* terrain;	// ownTerrain or a shared terrain
+	int burningCells;
+	unsigned int tick;
+
+	// Statistics (see getFrontLength()), burnableBits: cells on land with a fuel model that burns, one bit per cell
+	std::vector<uint64_t> burnableBits;
+	int extinguishedCells;
+	int frontEdges;
+	int ignitedCells;
+	float rateOfSpread;
+
+	/***
+	Active front: packed indices of the burning cells that still have an unburnt neighbour.
+	Double-buffered, the front of the next time step is built while the current one is read.
+	Burning cells without unburnt neighbours leave the front, only the burnout wheel extinguishes them.
+	All lists are reserved in setup() so that step() never allocates.
+	The grid step does not use the lists, they are rebuilt from the state raster when the front step takes over.
+	***/
+	std::vector<int> front[2];
+	int currentFront;
+	bool frontOutdated;
+	std::vector<int> changedCells;
+
+	/***
+	Grid step
+	ignitionThresholds[model][n][band]: probability for a cell of the fuel model to catch fire from its neighbour n,
+	as a 15 bit integer minus one (see FireGridKernels::ignite()), for each slope band from the neighbour towards
+	the cell. Rebuilt when the model parameters change, the front step reads the same table.
+	fuel is padded to a whole number of 64 cell words.
+	***/
+	StepMode stepMode;
+	FireGridKernels gridKernels;
+	FireRandom random;
+	int16_t ignitionThresholds[numberOfFuelModels][FireTerrain::numberOfNeighbours][FireTerrain::numberOfSlopeBands];
+	std::vector<uint64_t> burningBits;		// burning cells at the beginning of the time step, with zero words around
+	std::vector<uint64_t> ignitionBits;
+	std::vector<int> burningWords;			// sorted indices of the words with burning cells
+	std::vector<int> nextBurningWords;
+	std::vector<int> ignitedWords;
+	bool burningWordsOutdated;			// after front steps and ignitions
+	std::vector<unsigned char> visitWords;		// one byte per word, padded to a multiple of 8 words
+	std::vector<uint64_t> extinguishedBits;
+	FireThreadPool threadPool;
+	std::vector<IgnitionDraws> threadDraws;		// one per thread
+	std::vector<std::vector<int> > tileIgnitedWords;
+
+	/***
+	Event step
+	Priority queue of the events of the burning cells: the events are at most maximumBurnDuration time steps ahead, so
+	they are kept in one bucket per time step (tick % eventBuckets), pushed and popped in constant time.
+		- spreadEvents: (cell, source) the fire spreads from source into cell during the time step
+		- burnoutEvents: cell is extinguished at the end of the time step (after the spreads)
+	The events are scheduled again from the state raster and the fuel when the event step takes over (or after
+	ignite()).
+	ignitionLogMisses[model][n][band]: log of the probability for a cell of the fuel model not to catch fire from its
+	neighbour n in a time step.
+	***/
+	static const int eventBuckets = maximumBurnDuration + 1;
+	std::vector<std::pair<int, int> > spreadEvents[eventBuckets];
+	bool eventsOutdated;	// after front and grid steps and ignitions
+	float ignitionLogMisses[numberOfFuelModels][FireTerrain::numberOfNeighbours][FireTerrain::numberOfSlopeBands];
+
+	/***
+	Burnout wheel of the front and event steps: the cells that are extinguished at the end of a time step, in the
+	bucket tick % eventBuckets. A cell is added once when it catches fire and visited once when it burns out, so the
+	cells that no longer spread cost nothing until then (the fuel of the burning cells is not decreased at every
+	time step). The fuel of the burning cells is updated from the wheel when the grid step takes over, and the
+	wheel is filled from the fuel when the front or event step takes over.
+	***/
+	std::vector<int> burnoutWheel[eventBuckets];
+	bool fuelOutdated;		// the burnout wheel holds the fuel of the burning cells, after front and event steps
+
+	// Model parameters
+	float windAngle;
+	float windVelocity;
+	Neighbourhood neighbourhood;
+	VegetationType vegType;
+	SpreadKernel spreadKernel;
+	// spreadProbabilities[model][n][band]: see getSpreadProbability()
+	float spreadProbabilities[numberOfFuelModels][FireTerrain::numberOfNeighbours][FireTerrain::numberOfSlopeBands];
+
+	unsigned int seed;
+};
@@ -0,0 +1,51 @@
+/***********************************************************************
+FireStateRaster - cell states of the fire spread model packed in 2 bits.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireStateRaster.h"
+
+#include <algorithm>
+
+FireStateRaster::FireStateRaster()
+:cols(0),
+rows(0)
+{
+}
+
+void FireStateRaster::setup(int scols, int srows) {
+	cols = scols;
+	rows = srows;
+	int words = (cols * rows + 63) / 64;
+	low.assign(words, 0);
+	high.assign(words, 0);
+
+	firstColumn.assign(words, 0);
+	lastColumn.assign(words, 0);
+	for (int y = 0; y < rows; y++) {
+		int first = y * cols;
+		int last = first + cols - 1;
+		firstColumn[first >> 6] |= static_cast<uint64_t>(1) << (first & 63);
+		lastColumn[last >> 6] |= static_cast<uint64_t>(1) << (last & 63);
+	}
+}
+
+void FireStateRaster::clear() {
+	std::fill(low.begin(), low.end(), 0);
+	std::fill(high.begin(), high.end(), 0);
+}
@@ -0,0 +1,118 @@
+/***********************************************************************
+FireStateRaster - cell states of the fire spread model packed in 2 bits.
+The states are stored as two bit planes (low and high bit of the state),
+bit i % 64 of word i / 64 being the cell of packed index i, so that 64
+cells of a row can be tested with one integer operation.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+class FireStateRaster {
+public:
+	FireStateRaster();
+
+	void setup(int cols, int rows);
+	// Sets every cell to 0
+	void clear();
+
+	// State (0 - 3) of a cell, 0 and 1 are the unburnt and burning states of FireSpreadEngine
+	int get(int index) const {
+		int bit = index & 63;
+		return static_cast<int>(((low[index >> 6] >> bit) & 1) | (((high[index >> 6] >> bit) & 1) << 1));
+	}
+	bool isUnburnt(int index) const {
+		return (((low[index >> 6] | high[index >> 6]) >> (index & 63)) & 1) == 0;
+	}
+	bool isBurning(int index) const {
+		return (((low[index >> 6] & ~high[index >> 6]) >> (index & 63)) & 1) != 0;
+	}
+	void set(int index, int state) {
+		uint64_t mask = static_cast<uint64_t>(1) << (index & 63);
+		uint64_t& lowWord = low[index >> 6];
+		uint64_t& highWord = high[index >> 6];
+		lowWord = (state & 1) ? (lowWord | mask) : (lowWord & ~mask);
+		highWord = (state & 2) ? (highWord | mask) : (highWord & ~mask);
+	}
+
+	// Bit planes, the bits after the last cell are always 0
+	int getNumberOfWords() const {
+		return static_cast<int>(low.size());
+	}
+	uint64_t* getLowBits() {
+		return low.data();
+	}
+	uint64_t* getHighBits() {
+		return high.data();
+	}
+	const uint64_t* getLowBits() const {
+		return low.data();
+	}
+	const uint64_t* getHighBits() const {
+		return high.data();
+	}
+	// Bits of the cells in the first and in the last column of the raster
+	const uint64_t* getFirstColumnBits() const {
+		return firstColumn.data();
+	}
+	const uint64_t* getLastColumnBits() const {
+		return lastColumn.data();
+	}
+
+	// Bit manipulation helpers
+	static int lowestBit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long bit;
+		_BitScanForward64(&bit, bits);
+		return static_cast<int>(bit);
+#elif defined(_MSC_VER)
+		unsigned long bit;
+		if (_BitScanForward(&bit, static_cast<unsigned long>(bits)))
+			return static_cast<int>(bit);
+		_BitScanForward(&bit, static_cast<unsigned long>(bits >> 32));
+		return static_cast<int>(bit) + 32;
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+	static int countBits(uint64_t bits) {
+#ifdef _MSC_VER
+		// the popcnt instruction is not available on every processor
+		bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+		bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+		bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+		return static_cast<int>((bits * 0x0101010101010101ULL) >> 56);
+#else
+		return __builtin_popcountll(bits);
+#endif
+	}
+
+private:
+	int cols, rows;
+	std::vector<uint64_t> low;
+	std::vector<uint64_t> high;
+	std::vector<uint64_t> firstColumn;
+	std::vector<uint64_t> lastColumn;
+};
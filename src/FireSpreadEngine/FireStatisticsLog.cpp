@@ -0,0 +1,47 @@
+/***********************************************************************
+FireStatisticsLog - CSV file of the statistics of the fire spread model.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireStatisticsLog.h"
+
+bool FireStatisticsLog::open(const std::string& path) {
+	close();
+	out.open(path.c_str(), std::ios::trunc);
+	if (!out)
+		return false;
+	out << "tick,burning_cells,extinguished_cells,burnt_cells,front_length,ignited_cells,rate_of_spread\n";
+	return true;
+}
+
+void FireStatisticsLog::close() {
+	if (out.is_open())
+		out.close();
+}
+
+void FireStatisticsLog::append(const FireSpreadEngine& engine) {
+	if (!out.is_open())
+		return;
+	out << engine.getTick() << ','
+		<< engine.getNumberOfBurningCells() << ','
+		<< engine.getNumberOfExtinguishedCells() << ','
+		<< engine.getNumberOfBurntCells() << ','
+		<< engine.getFrontLength() << ','
+		<< engine.getNumberOfIgnitedCells() << ','
+		<< engine.getRateOfSpread() << '\n';
+}
@@ -0,0 +1,43 @@
+/***********************************************************************
+FireStatisticsLog - CSV file of the statistics of the fire spread model,
+one row per time step, to plot a fire in a spreadsheet after a lesson.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "FireSpreadEngine.h"
+
+class FireStatisticsLog {
+public:
+	// Creates the file and writes the header, returns false if it cannot be written
+	bool open(const std::string& path);
+	void close();
+	bool isOpen() const {
+		return out.is_open();
+	}
+
+	// Appends the statistics of the engine after a time step (read from its counters, no pass over the raster)
+	void append(const FireSpreadEngine& engine);
+
+private:
+	std::ofstream out;
+};
@@ -0,0 +1,189 @@
+/***********************************************************************
+FireTerrain - elevation and slope rasters read by the fire spread step.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireTerrain.h"
+
+#include <algorithm>
+#include <cmath>
+
+FireTerrain::FireTerrain()
+:cols(0),
+rows(0),
+cellSize(1)
+{
+}
+
+void FireTerrain::setup(int scols, int srows, float scellSize) {
+	cols = scols;
+	rows = srows;
+	cellSize = scellSize;
+	elevation.assign(cols * rows, 0);
+	for (int n = 0; n < numberOfNeighbours; n++) {
+		slopes[n].assign(cols * rows, 0);
+		slopeBands[n].assign(cols * rows, GENTLE_UPHILL);
+	}
+	fuelModels.assign(cols * rows, 0);
+	updateLandBits();
+}
+
+FireTerrain::SlopeBand FireTerrain::slopeBand(float slope) {
+	if (slope > 30)
+		return STEEP_UPHILL;
+	else if (slope > 15)
+		return UPHILL;
+	else if (slope >= 0)
+		return GENTLE_UPHILL;
+	else if (slope > -15)
+		return GENTLE_DOWNHILL;
+	else if (slope > -30)
+		return DOWNHILL;
+	return STEEP_DOWNHILL;
+}
+
+/***
+Slope between a cell and its neighbours
+Reference: http://geology.isu.edu/wapi/geostac/Field_Exercise/topomaps/slope_calc.htm
+	slope = elevation change / horizontal distance * 100
+The horizontal distance between two neighbours is cellSize (cellSize * sqrt(2) for the diagonal ones), so the
+slope towards the left neighbour of a cell is the opposite of the slope towards the right from that neighbour.
+***/
+void FireTerrain::setElevation(const float* selevation) {
+	std::copy(selevation, selevation + cols * rows, elevation.begin());
+
+	float* left = slopes[LEFT].data();
+	float* right = slopes[RIGHT].data();
+	float* up = slopes[UP].data();
+	float* down = slopes[DOWN].data();
+
+	for (int y = 0; y < rows; y++) {
+		const float* e = elevation.data() + y * cols;
+		int row = y * cols;
+
+		left[row] = 0;
+		for (int x = 1; x < cols; x++) {
+			float s = ((e[x] - e[x - 1]) / cellSize) * 100;
+			right[row + x - 1] = s;
+			left[row + x] = -s;
+		}
+		right[row + cols - 1] = 0;
+
+		if (y == 0) {
+			std::fill(up, up + cols, 0.0f);
+		}
+		else {
+			const float* eUp = e - cols;
+			for (int x = 0; x < cols; x++) {
+				float s = ((e[x] - eUp[x]) / cellSize) * 100;
+				up[row + x] = -s;
+				down[row - cols + x] = s;
+			}
+		}
+	}
+	std::fill(down + (rows - 1) * cols, down + rows * cols, 0.0f);
+
+	// diagonal neighbours, from every cell towards the cells of the next row
+	float* upLeft = slopes[UP_LEFT].data();
+	float* downRight = slopes[DOWN_RIGHT].data();
+	float* upRight = slopes[UP_RIGHT].data();
+	float* downLeft = slopes[DOWN_LEFT].data();
+	const float diagonal = cellSize * std::sqrt(2.0f);
+	for (int n = UP_LEFT; n < numberOfNeighbours; n++)
+		std::fill(slopes[n].begin(), slopes[n].end(), 0.0f);
+	for (int y = 0; y < rows - 1; y++) {
+		const float* e = elevation.data() + y * cols;
+		const float* eDown = e + cols;
+		int row = y * cols;
+		for (int x = 0; x < cols - 1; x++) {
+			float s = ((eDown[x + 1] - e[x]) / diagonal) * 100;
+			downRight[row + x] = s;
+			upLeft[row + cols + x + 1] = -s;
+		}
+		for (int x = 1; x < cols; x++) {
+			float s = ((eDown[x - 1] - e[x]) / diagonal) * 100;
+			downLeft[row + x] = s;
+			upRight[row + cols + x - 1] = -s;
+		}
+	}
+
+	for (int n = 0; n < numberOfNeighbours; n++) {
+		for (int i = 0; i < cols * rows; i++)
+			slopeBands[n][i] = static_cast<unsigned char>(slopeBand(slopes[n][i]));
+	}
+	updateLandBits();
+}
+
+void FireTerrain::setElevation(const float* selevation, int x, int y, int width, int height) {
+	int firstX = std::max(x, 0);
+	int firstY = std::max(y, 0);
+	int lastX = std::min(x + width, cols);
+	int lastY = std::min(y + height, rows);
+	for (int cellY = firstY; cellY < lastY; cellY++) {
+		int row = cellY * cols;
+		std::copy(selevation + row + firstX, selevation + row + lastX, elevation.begin() + row + firstX);
+		for (int cellX = firstX; cellX < lastX; cellX++) {
+			int i = row + cellX;
+			if (isWater(i))
+				landBits[i >> 6] &= ~(static_cast<uint64_t>(1) << (i & 63));
+			else
+				landBits[i >> 6] |= static_cast<uint64_t>(1) << (i & 63);
+		}
+	}
+
+	// the same slopes as setElevation(): from every cell towards its neighbours, 0 outside the raster
+	const float diagonal = cellSize * std::sqrt(2.0f);
+	float distances[numberOfNeighbours];
+	int offsets[numberOfNeighbours];
+	for (int n = 0; n < numberOfNeighbours; n++) {
+		distances[n] = n < UP_LEFT ? cellSize : diagonal;
+		offsets[n] = offsetY(n) * cols + offsetX(n);
+	}
+	for (int cellY = std::max(firstY - 1, 0); cellY < std::min(lastY + 1, rows); cellY++) {
+		bool innerRow = cellY > 0 && cellY < rows - 1;
+		for (int cellX = std::max(firstX - 1, 0); cellX < std::min(lastX + 1, cols); cellX++) {
+			int i = cellY * cols + cellX;
+			bool inner = innerRow && cellX > 0 && cellX < cols - 1;
+			for (int n = 0; n < numberOfNeighbours; n++) {
+				float s = 0;
+				int newX = cellX + offsetX(n);
+				int newY = cellY + offsetY(n);
+				if (inner || (newX >= 0 && newY >= 0 && newX < cols && newY < rows))
+					s = ((elevation[i + offsets[n]] - elevation[i]) / distances[n]) * 100;
+				slopes[n][i] = s;
+				slopeBands[n][i] = static_cast<unsigned char>(slopeBand(s));
+			}
+		}
+	}
+}
+
+void FireTerrain::setFuelModels(const unsigned char* models) {
+	std::copy(models, models + cols * rows, fuelModels.begin());
+}
+
+void FireTerrain::fillFuelModels(int model) {
+	std::fill(fuelModels.begin(), fuelModels.end(), static_cast<unsigned char>(model));
+}
+
+void FireTerrain::updateLandBits() {
+	landBits.assign((cols * rows + 63) / 64, 0);
+	for (int i = 0; i < cols * rows; i++) {
+		if (!isWater(i))
+			landBits[i >> 6] |= static_cast<uint64_t>(1) << (i & 63);
+	}
+}
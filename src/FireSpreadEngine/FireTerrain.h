@@ -0,0 +1,146 @@
+/***********************************************************************
+FireTerrain - elevation, slope and fuel model rasters read by the fire
+spread step. The slopes towards the four neighbours of every cell are
+computed once when a new elevation raster is set (once per new depth
+frame) so the spread step only reads contiguous float arrays.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class FireTerrain {
+public:
+	// Neighbours of a cell, in kinect coordinates: the four neighbours sharing an edge, then the four diagonal ones.
+	// The opposite of a neighbour is neighbour ^ 1.
+	enum Neighbour {
+		LEFT = 0,		// x - 1
+		RIGHT = 1,		// x + 1
+		UP = 2,			// y - 1
+		DOWN = 3,		// y + 1
+		UP_LEFT = 4,	// x - 1, y - 1
+		DOWN_RIGHT = 5,	// x + 1, y + 1
+		UP_RIGHT = 6,	// x + 1, y - 1
+		DOWN_LEFT = 7	// x - 1, y + 1
+	};
+	static const int numberOfNeighbours = 8;
+	static int opposite(int neighbour) {
+		return neighbour ^ 1;
+	}
+	static int offsetX(int neighbour) {
+		static const int offsets[numberOfNeighbours] = { -1, 1, 0, 0, -1, 1, 1, -1 };
+		return offsets[neighbour];
+	}
+	static int offsetY(int neighbour) {
+		static const int offsets[numberOfNeighbours] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+		return offsets[neighbour];
+	}
+
+	/***
+	Slope bands of the fire spread probabilities (slope in percent)
+	Reference: Weise and Biging (1997), see FireSpreadEngine
+	***/
+	enum SlopeBand {
+		STEEP_DOWNHILL = 0,		// slope <= -30
+		DOWNHILL = 1,			// -30 < slope <= -15
+		GENTLE_DOWNHILL = 2,	// -15 < slope < 0
+		GENTLE_UPHILL = 3,		// 0 <= slope <= 15
+		UPHILL = 4,				// 15 < slope <= 30
+		STEEP_UPHILL = 5		// slope > 30
+	};
+	static const int numberOfSlopeBands = 6;
+	static SlopeBand slopeBand(float slope);
+
+	FireTerrain();
+
+	void setup(int cols, int rows, float cellSize);
+	int getCols() const {
+		return cols;
+	}
+	int getRows() const {
+		return rows;
+	}
+	float getCellSize() const {
+		return cellSize;
+	}
+
+	// Elevation of every cell, row-major (cols * rows values). Cells below 0 are water.
+	// Recomputes the eight slope rasters.
+	void setElevation(const float* elevation);
+	// Same for the cells of an area only (elevation is still the whole raster, only the area is read): the slopes
+	// between the area and the cells around it are recomputed too, the other cells keep their elevation
+	void setElevation(const float* elevation, int x, int y, int width, int height);
+
+	float getElevation(int index) const {
+		return elevation[index];
+	}
+	bool isWater(int index) const {
+		return elevation[index] < 0;
+	}
+	// Slope in percent from a cell towards one of its neighbours (+ve : uphill; -ve: downhill), over the distance
+	// between their centres (cellSize, or cellSize * sqrt(2) for the diagonal neighbours).
+	// The value is 0 for neighbours outside the raster
+	float getSlope(int neighbour, int index) const {
+		return slopes[neighbour][index];
+	}
+	const float* getSlopes(int neighbour) const {
+		return slopes[neighbour].data();
+	}
+	// Slope band from a cell towards one of its neighbours, computed with the slopes
+	int getSlopeBand(int neighbour, int index) const {
+		return slopeBands[neighbour][index];
+	}
+	const unsigned char* getSlopeBands(int neighbour) const {
+		return slopeBands[neighbour].data();
+	}
+	const float* getElevations() const {
+		return elevation.data();
+	}
+	// Cells on land, one bit per cell (see FireStateRaster)
+	const uint64_t* getLandBits() const {
+		return landBits.data();
+	}
+
+	// Fuel model of every cell (FireSpreadEngine::VegetationType), row-major (cols * rows values), 0 after setup()
+	// The fuel models do not depend on the elevation, they are kept when the elevation changes.
+	void setFuelModels(const unsigned char* models);
+	void setFuelModel(int index, int model) {
+		fuelModels[index] = static_cast<unsigned char>(model);
+	}
+	// Gives the same fuel model to every cell
+	void fillFuelModels(int model);
+	int getFuelModel(int index) const {
+		return fuelModels[index];
+	}
+	const unsigned char* getFuelModels() const {
+		return fuelModels.data();
+	}
+
+private:
+	void updateLandBits();
+
+	int cols, rows;
+	float cellSize;
+	std::vector<float> elevation;
+	std::vector<float> slopes[numberOfNeighbours];
+	std::vector<unsigned char> slopeBands[numberOfNeighbours];
+	std::vector<uint64_t> landBits;
+	std::vector<unsigned char> fuelModels;
+};
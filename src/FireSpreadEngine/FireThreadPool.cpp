@@ -0,0 +1,109 @@
+/***********************************************************************
+FireThreadPool - worker threads of the grid step of the fire spread model.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "FireThreadPool.h"
+
+FireThreadPool::FireThreadPool()
+:task(0),
+numberOfTasks(0),
+nextTask(0),
+busyWorkers(0),
+generation(0),
+stopping(false)
+{
+}
+
+FireThreadPool::~FireThreadPool() {
+	stopWorkers();
+}
+
+void FireThreadPool::setNumberOfThreads(int threads) {
+	if (threads < 1)
+		threads = 1;
+	if (threads == getNumberOfThreads())
+		return;
+
+	stopWorkers();
+	for (int thread = 1; thread < threads; thread++)
+		workers.push_back(std::thread(&FireThreadPool::work, this, thread, generation));
+}
+
+void FireThreadPool::stopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+	stopping = false;
+}
+
+void FireThreadPool::run(int tasks, const Task& stask) {
+	// not worth waking up the workers
+	if (workers.empty() || tasks <= 1) {
+		for (int i = 0; i < tasks; i++)
+			stask(i, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = &stask;
+		numberOfTasks = tasks;
+		nextTask = 0;
+		busyWorkers = static_cast<int>(workers.size());
+		generation++;
+	}
+	wake.notify_all();
+	runTasks(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (busyWorkers > 0)
+		done.wait(lock);
+	task = 0;
+}
+
+// lastGeneration: generation when the thread was created, it only runs the tasks of the next calls to run()
+void FireThreadPool::work(int thread, unsigned int lastGeneration) {
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stopping && generation == lastGeneration)
+				wake.wait(lock);
+			if (stopping)
+				return;
+			lastGeneration = generation;
+		}
+
+		runTasks(thread);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		busyWorkers--;
+		if (busyWorkers == 0)
+			done.notify_one();
+	}
+}
+
+void FireThreadPool::runTasks(int thread) {
+	for (int i = nextTask++; i < numberOfTasks; i = nextTask++)
+		(*task)(i, thread);
+}
@@ -0,0 +1,66 @@
+/***********************************************************************
+FireThreadPool - worker threads of the grid step of the fire spread model.
+The calling thread runs tasks too, the other threads sleep between two
+calls to run().
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class FireThreadPool {
+public:
+	// Task of run(): index of the task and index of the thread running it (0 - getNumberOfThreads() - 1)
+	typedef std::function<void(int task, int thread)> Task;
+
+	// Only the calling thread until setNumberOfThreads() is called
+	FireThreadPool();
+	~FireThreadPool();
+
+	// Number of threads running the tasks, including the calling thread (at least 1)
+	void setNumberOfThreads(int threads);
+	int getNumberOfThreads() const {
+		return static_cast<int>(workers.size()) + 1;
+	}
+
+	// Runs task(i, thread) for every i in [0, tasks) and returns when all of them are done
+	// The tasks are handed out in order to the threads that are free, they must not depend on each other
+	void run(int tasks, const Task& task);
+
+private:
+	void stopWorkers();
+	void work(int thread, unsigned int lastGeneration);
+	void runTasks(int thread);
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const Task* task;
+	int numberOfTasks;
+	std::atomic<int> nextTask;
+	int busyWorkers;
+	unsigned int generation;	// incremented by every call to run()
+	bool stopping;
+};
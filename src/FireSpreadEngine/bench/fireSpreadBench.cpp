@@ -0,0 +1,119 @@
+/***********************************************************************
+fireSpreadBench - runs the headless FireSpreadEngine on a synthetic
+sandbox terrain and reports the cost of the spread step.
+
+usage: fireSpreadBench [cols rows [ticks [seed [mode [isa [threads [neighbours]]]]]]]
+	mode: front, grid, auto (default) or event
+	isa: instruction set of the grid step, portable, sse2 or avx2 (default: best supported)
+	threads: threads of the grid step (default: all cores), the checksum does not depend on it
+	neighbours: 4 (default) or 8, the neighbours a burning cell spreads to
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "FireSpreadEngine.h"
+
+// Hills and a lake, in the same units as the sandbox (elevation in mm, 2 kinect pixels per cell)
+static std::vector<float> makeTerrain(int cols, int rows) {
+	std::vector<float> elevation(cols * rows);
+	for (int y = 0; y < rows; y++) {
+		for (int x = 0; x < cols; x++) {
+			float hills = 40 * std::sin(x * 0.05f) * std::cos(y * 0.07f) + 20 * std::sin((x + y) * 0.02f);
+			float dx = x - cols * 0.75f;
+			float dy = y - rows * 0.25f;
+			float lake = -120 * std::exp(-(dx * dx + dy * dy) / (0.01f * cols * rows));
+			elevation[y * cols + x] = 70 + hills + lake;
+		}
+	}
+	return elevation;
+}
+
+int main(int argc, char* argv[]) {
+	int cols = argc > 2 ? std::atoi(argv[1]) : 261;
+	int rows = argc > 2 ? std::atoi(argv[2]) : 157;
+	int ticks = argc > 3 ? std::atoi(argv[3]) : 1000;
+	unsigned int seed = argc > 4 ? static_cast<unsigned int>(std::atoi(argv[4])) : 1;
+	const char* mode = argc > 5 ? argv[5] : "auto";
+	const char* isa = argc > 6 ? argv[6] : "";
+	int threads = argc > 7 ? std::atoi(argv[7]) : 0;
+	int neighbours = argc > 8 ? std::atoi(argv[8]) : 4;
+
+	std::vector<float> elevation = makeTerrain(cols, rows);
+
+	FireSpreadEngine engine;
+	engine.setup(cols, rows, 2);
+	engine.setSeed(seed);
+	if (std::strcmp(mode, "front") == 0)
+		engine.setStepMode(FireSpreadEngine::FRONT_STEP);
+	else if (std::strcmp(mode, "grid") == 0)
+		engine.setStepMode(FireSpreadEngine::GRID_STEP);
+	else if (std::strcmp(mode, "event") == 0)
+		engine.setStepMode(FireSpreadEngine::EVENT_STEP);
+	else
+		engine.setStepMode(FireSpreadEngine::AUTOMATIC_STEP);
+	bool supported = true;
+	if (std::strcmp(isa, "portable") == 0)
+		supported = engine.setInstructionSet(FireGridKernels::PORTABLE);
+	else if (std::strcmp(isa, "sse2") == 0)
+		supported = engine.setInstructionSet(FireGridKernels::SSE2);
+	else if (std::strcmp(isa, "avx2") == 0)
+		supported = engine.setInstructionSet(FireGridKernels::AVX2);
+	if (!supported) {
+		std::cerr << isa << " is not supported on this processor" << std::endl;
+		return 1;
+	}
+	if (threads > 0)
+		engine.setNumberOfThreads(threads);
+	engine.setElevation(elevation.data());
+	engine.setWindSpeed(FireSpreadEngine::HIGH_WIND);
+	engine.setWindDirection(FireSpreadEngine::WEST);
+	engine.setVegetationType(FireSpreadEngine::PINUS);
+	if (neighbours == 8)
+		engine.setNeighbourhood(FireSpreadEngine::MOORE);
+	engine.ignite(cols / 2, rows / 2);
+
+	int ticksRun = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (; ticksRun < ticks && engine.getNumberOfBurningCells() > 0; ticksRun++) {
+		engine.step();
+		engine.clearChangedCells();
+	}
+	auto end = std::chrono::steady_clock::now();
+	double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+	int burnt = 0;
+	unsigned long long checksum = 1469598103934665603ULL;
+	for (int i = 0; i < cols * rows; i++) {
+		int cell = engine.getCellState(i);
+		if (cell != FireSpreadEngine::UNBURNT)
+			burnt++;
+		checksum = (checksum ^ static_cast<unsigned long long>(cell)) * 1099511628211ULL;
+	}
+
+	std::cout << "grid " << cols << "x" << rows << ", seed " << seed << ", " << mode << " step, " << FireGridKernels::getName(engine.getInstructionSet())
+		<< ", " << engine.getNumberOfThreads() << " thread(s), " << engine.getNumberOfNeighbours() << " neighbours" << std::endl;
+	std::cout << "ticks: " << ticksRun << ", burnt cells: " << burnt << ", checksum: " << std::hex << checksum << std::dec << std::endl;
+	std::cout << "total: " << ms << " ms, per tick: " << (ticksRun > 0 ? 1000 * ms / ticksRun : 0) << " us" << std::endl;
+	return 0;
+}
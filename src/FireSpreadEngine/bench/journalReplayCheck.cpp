@@ -0,0 +1,161 @@
+/***********************************************************************
+journalReplayCheck - records a session of the headless FireSpreadEngine
+in a SessionJournal (random frame times, starting point sliders, Start
+and Reset buttons), replays the journal in a new engine and checks that
+the replayed fire is the same cell for cell.
+
+usage: journalReplayCheck [journal file]
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FireSpreadEngine.h"
+#include "FireClock.h"
+#include "../../SessionJournal/SessionJournal.h"
+
+static const int cols = 261;
+static const int rows = 157;
+static const int frames = 600;
+
+// Session driven by the journal, as ofApp: the fire spreads with the seed of the journal and the inputs go
+// through the same function whether they are recorded or replayed
+class Session {
+public:
+	explicit Session(SessionJournal& sjournal)
+	:journal(sjournal),
+	startX(cols / 2),
+	startY(rows / 2)
+	{
+		std::vector<float> elevation(cols * rows);
+		for (int y = 0; y < rows; y++) {
+			for (int x = 0; x < cols; x++)
+				elevation[y * cols + x] = 70 + 40 * std::sin(x * 0.05f) * std::cos(y * 0.07f);
+		}
+		engine.setup(cols, rows, 2);
+		engine.setSeed(journal.getSeed());
+		engine.setElevation(elevation.data());
+		engine.setWindSpeed(FireSpreadEngine::HIGH_WIND);
+		engine.setWindDirection(FireSpreadEngine::WEST);
+		clock.setTicksPerSecond(30);
+	}
+
+	void frame(double elapsed) {
+		for (int ticks = clock.advance(elapsed); ticks > 0 && engine.getNumberOfBurningCells() > 0; ticks--) {
+			engine.step();
+			engine.clearChangedCells();
+		}
+	}
+	void slider(const std::string& name, float value) {
+		if (journal.isRecording())
+			journal.writeSlider(name, value);
+		if (name == "Start X")
+			startX = static_cast<int>(value);
+		else if (name == "Start Y")
+			startY = static_cast<int>(value);
+	}
+	void button(const std::string& name) {
+		if (journal.isRecording())
+			journal.writeButton(name);
+		if (name == "Start")
+			engine.ignite(startX, startY);
+		else if (name == "Reset")
+			engine.reset();
+	}
+
+	unsigned long long getChecksum() const {
+		unsigned long long checksum = 1469598103934665603ULL;
+		for (int i = 0; i < cols * rows; i++)
+			checksum = (checksum ^ static_cast<unsigned long long>(engine.getCellState(i))) * 1099511628211ULL;
+		return checksum;
+	}
+	unsigned int getTick() const {
+		return engine.getTick();
+	}
+
+private:
+	SessionJournal& journal;
+	FireSpreadEngine engine;
+	FireClock clock;
+	int startX, startY;
+};
+
+static unsigned long long record(const std::string& path) {
+	SessionJournal journal;
+	std::random_device device;
+	if (!journal.startRecording(path, device())) {
+		std::cerr << "cannot record the session in " << path << std::endl;
+		return 0;
+	}
+	Session session(journal);
+	std::mt19937 generator(device());
+	std::uniform_real_distribution<double> frameTime(0.01, 0.03);
+	std::uniform_int_distribution<int> x(0, cols - 1), y(0, rows - 1);
+	for (int i = 0; i < frames; i++) {
+		double elapsed = frameTime(generator);
+		journal.writeFrame(elapsed);
+		session.frame(elapsed);
+		if (i % 200 == 10) {
+			session.button("Reset");
+			session.slider("Start X", static_cast<float>(x(generator)));
+			session.slider("Start Y", static_cast<float>(y(generator)));
+			session.button("Start");
+		}
+	}
+	journal.close();
+	std::cout << "recorded: seed " << journal.getSeed() << ", tick " << session.getTick() << ", checksum " << std::hex << session.getChecksum() << std::dec << std::endl;
+	return session.getChecksum();
+}
+
+static unsigned long long replay(const std::string& path) {
+	SessionJournal journal;
+	if (!journal.startReplay(path)) {
+		std::cerr << "cannot replay the session of " << path << std::endl;
+		return 0;
+	}
+	Session session(journal);
+	double elapsed;
+	while (journal.readFrame(elapsed)) {
+		session.frame(elapsed);
+		SessionJournal::InputEvent event;
+		while (journal.readInputEvent(event)) {
+			if (event.type == SessionJournal::SLIDER_RECORD)
+				session.slider(event.name, event.value);
+			else if (event.type == SessionJournal::BUTTON_RECORD)
+				session.button(event.name);
+		}
+	}
+	std::cout << "replayed: seed " << journal.getSeed() << ", tick " << session.getTick() << ", checksum " << std::hex << session.getChecksum() << std::dec << std::endl;
+	return session.getChecksum();
+}
+
+int main(int argc, char* argv[]) {
+	std::string path = argc > 1 ? argv[1] : "build/journalReplayCheck.fsj";
+	unsigned long long recorded = record(path);
+	unsigned long long replayed = replay(path);
+	if (recorded == 0 || recorded != replayed) {
+		std::cerr << "the replayed fire differs from the recorded fire" << std::endl;
+		return 1;
+	}
+	std::cout << "the replayed fire is the same as the recorded fire" << std::endl;
+	return 0;
+}
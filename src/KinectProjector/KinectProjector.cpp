@@ -31,9 +31,11 @@ KinectProjector::KinectProjector(std::shared_ptr<ofAppBaseWindow> const& p)
 projKinectCalibrated(false),
 calibrating (false),
 basePlaneUpdated (false),
+depthFrameUpdated (false),
 projKinectCalibrationUpdated (false),
 ROIUpdated (false),
 imageStabilized (false),
+journal(0),
 waitingForFlattenSand (false),
 drawKinectView(false)
 {
@@ -188,15 +190,26 @@ void KinectProjector::update(){
     basePlaneUpdated = false;
     ROIUpdated = false;
     projKinectCalibrationUpdated = false;
+    depthFrameUpdated = false;
 
 	if (displayGui)
 		gui->update();
 
-    // Get depth image from kinect grabber
+    // Get depth image from kinect grabber, or from the journal of a recorded session
+    bool replaying = journal != 0 && journal->isReplaying();
     ofFloatPixels filteredframe;
-    if (kinectgrabber.filtered.tryReceive(filteredframe)) {
+    int journalWidth, journalHeight;
+    bool journalStabilized;
+    if (replaying && journal->readDepthFrame(journalWidth, journalHeight, journalStabilized)) {
+        FilteredDepthImage.setFromPixels(journal->getDepthFrame(), journalWidth, journalHeight);
+        FilteredDepthImage.updateTexture();
+        depthFrameUpdated = true;
+        imageStabilized = journalStabilized;
+    }
+    else if (!replaying && kinectgrabber.filtered.tryReceive(filteredframe)) {
         FilteredDepthImage.setFromPixels(filteredframe.getData(), kinectRes.x, kinectRes.y);
         FilteredDepthImage.updateTexture();
+        depthFrameUpdated = true;
         
         // Get color image from kinect grabber
         ofPixels coloredframe;
@@ -214,7 +227,10 @@ void KinectProjector::update(){
         
         // Is the depth image stabilized
         imageStabilized = kinectgrabber.isImageStabilized();
-        
+        if (journal != 0 && journal->isRecording())
+            journal->writeDepthFrame(filteredframe.getData(), filteredframe.getWidth(), filteredframe.getHeight(), imageStabilized);
+    }
+    if (depthFrameUpdated) {
         // Are we calibrating ?
         if (calibrating && !waitingForFlattenSand) {
             updateCalibration();
@@ -798,6 +814,36 @@ ofVec2f KinectProjector::kinectCoordToProjCoord(float x, float y) // x, y in kin
     return worldCoordToProjCoord(kinectCoordToWorldCoord(x, y));
 }
 
+// Same as kinectCoordToProjCoord() for many points: the kinect to world and world to projector matrices are combined
+// once for the whole batch
+//    projector = kinectProjMatrix * (z * kinectWorldMatrix * (x, y, z, 1), 1)
+//              = z * (m * (x, y, z, 1)) + t    with m = kinectProjMatrix[0..2][0..2] * kinectWorldMatrix[0..2] and
+//                                                   t = kinectProjMatrix[0..2][3]
+void KinectProjector::kinectCoordsToProjCoords(const ofVec2f* kinectCoords, int count, ofVec2f* projCoords)
+{
+    float m[3][4];
+    for (int r = 0; r < 3; r++){
+        for (int c = 0; c < 4; c++){
+            m[r][c] = 0;
+            for (int k = 0; k < 3; k++)
+                m[r][c] += kinectProjMatrix(r, k)*kinectWorldMatrix(k, c);
+        }
+    }
+    const float* depth = FilteredDepthImage.getFloatPixelsRef().getData();
+    int width = static_cast<int>(kinectRes.x);
+    int height = static_cast<int>(kinectRes.y);
+    for (int i = 0; i < count; i++){
+        float x = kinectCoords[i].x;
+        float y = kinectCoords[i].y;
+        int ind = static_cast<int>(ofClamp(y, 0, height-1)) * width + static_cast<int>(ofClamp(x, 0, width-1));
+        float z = depth[ind];
+        float sx = z*(m[0][0]*x + m[0][1]*y + m[0][2]*z + m[0][3]) + kinectProjMatrix(0, 3);
+        float sy = z*(m[1][0]*x + m[1][1]*y + m[1][2]*z + m[1][3]) + kinectProjMatrix(1, 3);
+        float sz = z*(m[2][0]*x + m[2][1]*y + m[2][2]*z + m[2][3]) + kinectProjMatrix(2, 3);
+        projCoords[i].set(sx/sz, sy/sz);
+    }
+}
+
 ofVec2f KinectProjector::worldCoordToProjCoord(ofVec3f vin)
 {
     ofVec4f wc = vin;
@@ -857,6 +903,37 @@ float KinectProjector::elevationAtKinectCoord(float x, float y) // x, y in kinec
     return elevation;
 }
 
+// Elevation of a cols x rows grid of kinect coordinates starting at (x, y), one every step pixels (row-major)
+// Same values as elevationAtKinectCoord() but the matrix product and the base plane are folded once for the whole grid:
+//    elevation = -(basePlaneEq.xyz . (kinectWorldMatrix*(x, y, z, 1)).xyz * z + basePlaneEq.w)
+//              = -((a.x*x + a.y*y + a.z*z + a.w) * z + basePlaneEq.w)
+// Points outside the kinect ROI are set to outsideValue
+void KinectProjector::elevationGridAtKinectCoord(float x, float y, float step, int cols, int rows, float* elevations, float outsideValue)
+{
+    ofVec3f planeNormal(basePlaneEq.x, basePlaneEq.y, basePlaneEq.z);
+    ofVec4f a(planeNormal.dot(ofVec3f(kinectWorldMatrix*ofVec4f(1, 0, 0, 0))),
+              planeNormal.dot(ofVec3f(kinectWorldMatrix*ofVec4f(0, 1, 0, 0))),
+              planeNormal.dot(ofVec3f(kinectWorldMatrix*ofVec4f(0, 0, 1, 0))),
+              planeNormal.dot(ofVec3f(kinectWorldMatrix*ofVec4f(0, 0, 0, 1))));
+
+    const float* depth = FilteredDepthImage.getFloatPixelsRef().getData();
+    for (int j = 0; j < rows; j++){
+        float ky = y + j*step;
+        bool rowInside = ky >= kinectROI.getTop() && ky <= kinectROI.getBottom() && ky < kinectRes.y;
+        float rowTerm = a.y*ky + a.w;
+        for (int i = 0; i < cols; i++){
+            float kx = x + i*step;
+            if (!rowInside || kx < kinectROI.getLeft() || kx > kinectROI.getRight() || kx >= kinectRes.x){
+                elevations[j*cols+i] = outsideValue;
+                continue;
+            }
+            int ind = static_cast<int>(ky) * kinectRes.x + static_cast<int>(kx);
+            float z = depth[ind];
+            elevations[j*cols+i] = -((a.x*kx + rowTerm + a.z*z)*z + basePlaneEq.w);
+        }
+    }
+}
+
 float KinectProjector::elevationToKinectDepth(float elevation, float x, float y) // x, y in kinect pixel coordinate
 {
     ofVec4f wc = kinectCoordToWorldCoord(x, y);
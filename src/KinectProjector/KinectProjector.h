@@ -34,6 +34,7 @@ General Public License for more details.
 
 #include "KinectProjectorCalibration.h"
 #include "Utils.h"
+#include "../SessionJournal/SessionJournal.h"
 
 class ofxModalThemeProjKinect : public ofxModalTheme {
 public:
@@ -61,10 +62,12 @@ public:
     ofVec2f worldCoordToProjCoord(ofVec3f vin);
 	ofVec3f projCoordAndWorldZToWorldCoord(float projX, float projY, float worldZ);
 	ofVec2f kinectCoordToProjCoord(float x, float y);
+	void kinectCoordsToProjCoords(const ofVec2f* kinectCoords, int count, ofVec2f* projCoords);
     ofVec3f kinectCoordToWorldCoord(float x, float y);
 	ofVec2f worldCoordTokinectCoord(ofVec3f wc);
 	ofVec3f RawKinectCoordToWorldCoord(float x, float y);
     float elevationAtKinectCoord(float x, float y);
+    void elevationGridAtKinectCoord(float x, float y, float step, int cols, int rows, float* elevations, float outsideValue);
     float elevationToKinectDepth(float elevation, float x, float y);
     ofVec2f gradientAtKinectCoord(float x, float y);
     
@@ -102,6 +105,9 @@ public:
     ofTexture & getTexture(){
         return FilteredDepthImage.getTexture();
     }
+    const ofFloatPixels & getFilteredDepthPixels(){
+        return FilteredDepthImage.getFloatPixelsRef();
+    }
     ofRectangle getKinectROI(){
         return kinectROI;
     }
@@ -135,6 +141,14 @@ public:
     bool isCalibrationUpdated(){ // To be called after update()
         return projKinectCalibrationUpdated;
     }
+    bool isDepthFrameUpdated(){ // To be called after update()
+        return depthFrameUpdated;
+    }
+    // Journal of the session: the filtered depth frames are written to it when recording,
+    // and read from it instead of the kinect grabber when replaying
+    void setJournal(SessionJournal* sjournal){
+        journal = sjournal;
+    }
     
 private:
     enum Calibration_state
@@ -205,7 +219,9 @@ private:
     bool ROIUpdated;
     bool projKinectCalibrationUpdated;
     bool basePlaneUpdated;
+    bool depthFrameUpdated;
     bool imageStabilized;
+    SessionJournal* journal;
     bool waitingForFlattenSand;
     bool drawKinectView;
     Calibration_state calibrationState;
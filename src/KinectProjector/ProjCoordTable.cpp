@@ -0,0 +1,112 @@
+/***********************************************************************
+ProjCoordTable - projector coordinates of a regular grid of kinect
+coordinates, projected again only where the depth changed.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "ProjCoordTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "KinectProjector.h"
+
+ProjCoordTable::ProjCoordTable()
+:left(0),
+top(0),
+pitch(1),
+cols(0),
+rows(0),
+tileSize(16),
+depthThreshold(2),
+outdated(true)
+{
+}
+
+void ProjCoordTable::setup(float sleft, float stop, float spitch, int scols, int srows, int stileSize) {
+	left = sleft;
+	top = stop;
+	pitch = spitch;
+	cols = std::max(scols, 2);
+	rows = std::max(srows, 2);
+	tileSize = std::max(stileSize, 1);
+	projCoords.assign(cols * rows, ofVec2f(0, 0));
+	depths.assign(cols * rows, 0);
+	tileKinectCoords.reserve(tileSize * tileSize);
+	tileProjCoords.reserve(tileSize * tileSize);
+	outdated = true;
+}
+
+int ProjCoordTable::update(KinectProjector& kinectProjector) {
+	const ofFloatPixels& depth = kinectProjector.getFilteredDepthPixels();
+	const float* depthData = depth.getData();
+	int width = static_cast<int>(depth.getWidth());
+	int height = static_cast<int>(depth.getHeight());
+	if (depthData == nullptr || width == 0 || height == 0)
+		return 0;	// no depth frame yet, the table stays outdated
+
+	int projectedTiles = 0;
+	for (int tileY = 0; tileY < rows; tileY += tileSize) {
+		for (int tileX = 0; tileX < cols; tileX += tileSize) {
+			int lastX = std::min(tileX + tileSize, cols);
+			int lastY = std::min(tileY + tileSize, rows);
+
+			// the depth of the points is read as kinectCoordsToProjCoords() reads it
+			bool changed = outdated;
+			for (int y = tileY; y < lastY && !changed; y++) {
+				int row = static_cast<int>(ofClamp(top + y * pitch, 0, height - 1)) * width;
+				for (int x = tileX; x < lastX && !changed; x++) {
+					float z = depthData[row + static_cast<int>(ofClamp(left + x * pitch, 0, width - 1))];
+					changed = std::fabs(z - depths[y * cols + x]) > depthThreshold;
+				}
+			}
+			if (!changed)
+				continue;
+
+			tileKinectCoords.clear();
+			for (int y = tileY; y < lastY; y++) {
+				int row = static_cast<int>(ofClamp(top + y * pitch, 0, height - 1)) * width;
+				for (int x = tileX; x < lastX; x++) {
+					tileKinectCoords.push_back(ofVec2f(left + x * pitch, top + y * pitch));
+					depths[y * cols + x] = depthData[row + static_cast<int>(ofClamp(left + x * pitch, 0, width - 1))];
+				}
+			}
+			tileProjCoords.resize(tileKinectCoords.size());
+			kinectProjector.kinectCoordsToProjCoords(tileKinectCoords.data(), static_cast<int>(tileKinectCoords.size()), tileProjCoords.data());
+			int i = 0;
+			for (int y = tileY; y < lastY; y++) {
+				for (int x = tileX; x < lastX; x++)
+					projCoords[y * cols + x] = tileProjCoords[i++];
+			}
+			projectedTiles++;
+		}
+	}
+	outdated = false;
+	return projectedTiles;
+}
+
+ofVec2f ProjCoordTable::getProjCoord(float kinectX, float kinectY) const {
+	float fx = ofClamp((kinectX - left) / pitch, 0, cols - 1);
+	float fy = ofClamp((kinectY - top) / pitch, 0, rows - 1);
+	int x = std::min(static_cast<int>(fx), cols - 2);
+	int y = std::min(static_cast<int>(fy), rows - 2);
+	float ax = fx - x;
+	float ay = fy - y;
+	const ofVec2f* p = &projCoords[y * cols + x];
+	return (p[0] * (1 - ax) + p[1] * ax) * (1 - ay) + (p[cols] * (1 - ax) + p[cols + 1] * ax) * ay;
+}
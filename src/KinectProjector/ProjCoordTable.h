@@ -0,0 +1,76 @@
+/***********************************************************************
+ProjCoordTable - projector coordinates of a regular grid of kinect
+coordinates (the points of the fire grid), kept between depth frames.
+A tile of points is only projected again when the filtered depth at one
+of its points moved by more than a threshold since it was projected, so
+projecting the cells of the fire and the objects on the sand is an
+array read instead of two matrix products and a division per point.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "ofMain.h"
+
+class KinectProjector;
+
+class ProjCoordTable {
+public:
+	ProjCoordTable();
+
+	// Grid of cols x rows points (at least 2 x 2) from the kinect coordinate (left, top), one every pitch pixels, in
+	// tiles of tileSize x tileSize points. Every point is projected at the next update.
+	void setup(float left, float top, float pitch, int cols, int rows, int tileSize = 16);
+	// Every point is projected again at the next update (after a calibration)
+	void setOutdated() {
+		outdated = true;
+	}
+	// Change of the filtered depth (kinect depth units) at a point for which its tile is projected again
+	void setDepthThreshold(float sdepthThreshold) {
+		depthThreshold = sdepthThreshold;
+	}
+
+	// Projects again the tiles in which the filtered depth changed, returns the number of tiles projected
+	int update(KinectProjector& kinectProjector);
+
+	int getCols() const {
+		return cols;
+	}
+	int getRows() const {
+		return rows;
+	}
+	const ofVec2f& getProjCoord(int x, int y) const {
+		return projCoords[y * cols + x];
+	}
+	// Projector coordinate of any kinect coordinate, interpolated between the four points around it (the nearest
+	// points of the grid outside of it, so the grid must cover every coordinate asked for)
+	ofVec2f getProjCoord(float kinectX, float kinectY) const;
+
+private:
+	float left, top, pitch;
+	int cols, rows;
+	int tileSize;
+	float depthThreshold;
+	bool outdated;
+	std::vector<ofVec2f> projCoords;
+	std::vector<float> depths;			// filtered depth of every point when it was projected
+	std::vector<ofVec2f> tileKinectCoords;	// points of the tile projected
+	std::vector<ofVec2f> tileProjCoords;
+};
@@ -0,0 +1,137 @@
+/***********************************************************************
+LayerCompositor - named layers of objects composited into one target,
+drawn again only where they changed.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "LayerCompositor.h"
+
+#include <algorithm>
+#include <cmath>
+
+LayerCompositor::LayerCompositor()
+:drawnPixels(0)
+{
+}
+
+void LayerCompositor::setup(int width, int height) {
+	target.allocate(width, height, GL_RGBA);
+	target.begin();
+	ofClear(255, 255, 255, 0);
+	target.end();
+	for (auto & layer : layers)
+		layer.bounds.clear();
+	dirtyAreas.clear();
+}
+
+void LayerCompositor::addLayer(const std::string& name, std::function<void()> draw) {
+	Layer layer;
+	layer.name = name;
+	layer.draw = draw;
+	layers.push_back(layer);
+}
+
+void LayerCompositor::setLayerBounds(const std::string& name, const std::vector<ofRectangle>& bounds) {
+	for (auto & layer : layers) {
+		if (layer.name != name)
+			continue;
+		// objects that disappeared or moved, then objects that appeared or moved
+		for (auto & area : layer.bounds) {
+			if (std::find(bounds.begin(), bounds.end(), area) == bounds.end())
+				setDirty(area);
+		}
+		for (auto & area : bounds) {
+			if (std::find(layer.bounds.begin(), layer.bounds.end(), area) == layer.bounds.end())
+				setDirty(area);
+		}
+		layer.bounds = bounds;
+		return;
+	}
+	ofLogError("LayerCompositor") << "setLayerBounds(): no layer " << name;
+}
+
+void LayerCompositor::setDirty(const ofRectangle& area) {
+	// whole pixels covering the area, inside the target
+	float left = std::max(std::floor(area.getLeft()), 0.0f);
+	float top = std::max(std::floor(area.getTop()), 0.0f);
+	float right = std::min(std::ceil(area.getRight()), target.getWidth());
+	float bottom = std::min(std::ceil(area.getBottom()), target.getHeight());
+	if (right > left && bottom > top)
+		dirtyAreas.push_back(ofRectangle(left, top, right - left, bottom - top));
+}
+
+void LayerCompositor::setDirty() {
+	dirtyAreas.clear();
+	dirtyAreas.push_back(ofRectangle(0, 0, target.getWidth(), target.getHeight()));
+}
+
+bool LayerCompositor::update() {
+	drawnPixels = 0;
+	if (dirtyAreas.empty())
+		return false;
+	mergeDirtyAreas();
+
+	// the rows of the fbo are drawn top down, as the scissor box counts them
+	target.begin();
+	glEnable(GL_SCISSOR_TEST);
+	for (auto & area : dirtyAreas) {
+		glScissor(area.x, area.y, area.width, area.height);
+		ofClear(255, 255, 255, 0);
+		for (auto & layer : layers)
+			layer.draw();
+		drawnPixels += area.width * area.height;
+	}
+	glDisable(GL_SCISSOR_TEST);
+	target.end();
+	dirtyAreas.clear();
+	return true;
+}
+
+// Areas that overlap or touch are merged, every area draws all the layers again so too many areas are merged into
+// their bounding box
+void LayerCompositor::mergeDirtyAreas() {
+	for (size_t i = 0; i < dirtyAreas.size(); i++) {
+		for (size_t j = i + 1; j < dirtyAreas.size(); ) {
+			const ofRectangle& area = dirtyAreas[j];
+			if (dirtyAreas[i].getLeft() <= area.getRight() && area.getLeft() <= dirtyAreas[i].getRight()
+				&& dirtyAreas[i].getTop() <= area.getBottom() && area.getTop() <= dirtyAreas[i].getBottom()) {
+				// the grown area is compared again with the following ones
+				dirtyAreas[i].growToInclude(area);
+				dirtyAreas[j] = dirtyAreas.back();
+				dirtyAreas.pop_back();
+				j = i + 1;
+			}
+			else {
+				j++;
+			}
+		}
+	}
+	if (static_cast<int>(dirtyAreas.size()) > maximumDirtyAreas) {
+		for (size_t i = 1; i < dirtyAreas.size(); i++)
+			dirtyAreas[0].growToInclude(dirtyAreas[i]);
+		dirtyAreas.resize(1);
+	}
+}
+
+void LayerCompositor::draw(float x, float y, float width, float height) const {
+	target.draw(x, y, width, height);
+}
+
+void LayerCompositor::draw(float x, float y) const {
+	target.draw(x, y);
+}
@@ -0,0 +1,84 @@
+/***********************************************************************
+LayerCompositor - named layers of objects drawn over the sandbox (fire
+perimeters, markers, houses, firemen) composited into one target at the
+projector resolution. Only the areas in which an object appeared, moved,
+disappeared or changed are cleared and drawn again: the other pixels of
+the target are kept from the previous frames.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ofMain.h"
+
+class LayerCompositor {
+public:
+	LayerCompositor();
+
+	// Transparent target of width x height pixels
+	void setup(int width, int height);
+
+	// Layers are drawn in the order they are added, draw() draws every object of the layer
+	void addLayer(const std::string& name, std::function<void()> draw);
+
+	/***
+	Areas covered by the objects of a layer (pixels of the target), set at every frame. The areas that were not in
+	the previous bounds of the layer and the previous areas that are gone are drawn again at the next update, so an
+	object that appears, moves or disappears is drawn without drawing the whole target again.
+	***/
+	void setLayerBounds(const std::string& name, const std::vector<ofRectangle>& bounds);
+	// An area to draw again, for an object that changed without moving
+	void setDirty(const ofRectangle& area);
+	// The whole target is drawn again
+	void setDirty();
+
+	/***
+	Clears the dirty areas and draws every layer again inside them (scissor test). Overlapping areas are merged
+	first, and the areas are merged into their bounding box when there are too many of them.
+	Returns false if nothing was drawn.
+	***/
+	bool update();
+
+	void draw(float x, float y, float width, float height) const;
+	void draw(float x, float y) const;
+
+	// Pixels cleared and drawn again by the last update
+	int getDrawnPixels() const {
+		return drawnPixels;
+	}
+
+private:
+	struct Layer {
+		std::string name;
+		std::function<void()> draw;
+		std::vector<ofRectangle> bounds;
+	};
+
+	void mergeDirtyAreas();
+
+	static const int maximumDirtyAreas = 16;
+
+	ofFbo target;
+	std::vector<Layer> layers;
+	std::vector<ofRectangle> dirtyAreas;	// whole pixels inside the target
+	int drawnPixels;
+};
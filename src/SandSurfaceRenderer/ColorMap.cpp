@@ -25,6 +25,21 @@ General Public License for more details.
 
 #include "ColorMap.h"
 
+bool ColorMap::setKeys(std::vector<ofColor> colorkeys, std::vector<double> heightkeys) {
+    if (colorkeys.size() != heightkeys.size() || colorkeys.size() < 2)
+        return false;
+    
+    heightMapKeys.clear();
+    for (int i = 0; i < colorkeys.size(); i++)
+        heightMapKeys.push_back(HeightMapKey(heightkeys[i], colorkeys[i]));
+    
+    std::sort(heightMapKeys.begin(), heightMapKeys.end());
+    
+    min = heightMapKeys.front().height;
+    max = heightMapKeys.back().height;
+    return updateColormap();
+}
+
 bool ColorMap::updateColormap() {
     if (entries.isAllocated())
         entries.clear();
@@ -129,6 +144,13 @@ ofTexture ColorMap::getTexture(void)  // return color map texture
     return tex.getTexture();
 }
 
+ofColor ColorMap::getColor(float scalar) const
+{
+    // Same entries as the texture used by the shaders
+    int i = ofClamp((scalar-min)/(max-min)*(numEntries-1)+0.5, 0, numEntries-1);
+    return entries.getColor(i, 0);
+}
+
 int ColorMap::size() const
 {
     return heightMapKeys.size();
@@ -59,6 +59,7 @@ public:
     void saveFile(string filename);
     bool createFile(string filename); //create a sample colormap file
     HeightMapKey operator[](int scalar) const; // Return a key
+    ofColor getColor(float scalar) const; // Return the color of a scalar value, clamped to the scalar value range
     int size() const;
     ofTexture getTexture(); // return color map texture
 
@@ -30,7 +30,17 @@ using namespace ofxCSG;
 
 SandSurfaceRenderer::SandSurfaceRenderer(std::shared_ptr<KinectProjector> const& k, std::shared_ptr<ofAppBaseWindow> const& p)
 :settingsLoaded(false),
-editColorMap(false){
+editColorMap(false),
+drawBurnProbabilities(false),
+burnProbabilityCols(0),
+fireCols(0),
+fireRows(0),
+fireLeft(0),
+fireTop(0),
+firePitch(1),
+firstFireRowChanged(0),
+lastFireRowChanged(-1),
+drawFire(false){
     kinectProjector = k;
     projWindow = p;
 }
@@ -105,6 +115,11 @@ void SandSurfaceRenderer::setup(bool sdisplayGui){
     //setup the mesh
     setupMesh();
     
+    // Burn probability colors, from unlikely (yellow) to certain (dark red)
+    std::vector<ofColor> burnColors{ ofColor(255, 255, 0), ofColor(255, 128, 0), ofColor(200, 0, 0) };
+    std::vector<double> burnProbabilityKeys{ 0, 0.5, 1 };
+    burnProbabilityMap.setKeys(burnColors, burnProbabilityKeys);
+    
 	// Load shaders
     bool loaded = true;
 #ifdef TARGET_OPENGLES
@@ -246,6 +261,8 @@ void SandSurfaceRenderer::drawProjectorWindow(){
 }
 
 void SandSurfaceRenderer::drawSandbox() {
+    // before the depth texture is bound to the first texture unit
+    uploadFireStates();
     fboProjWindow.begin();
     ofBackground(0);
     kinectProjector->bind();
@@ -259,12 +276,125 @@ void SandSurfaceRenderer::drawSandbox() {
     heightMapShader.setUniformTexture("pixelCornerElevationSampler", contourLineFramebufferObject.getTexture(), 3);
     heightMapShader.setUniform1f("contourLineFactor", contourLineFactor);
     heightMapShader.setUniform1i("drawContourLines", drawContourLines);
+    heightMapShader.setUniform1i("drawFire", drawFire && fireStateTexture.isAllocated());
+    if (fireStateTexture.isAllocated()) {
+        heightMapShader.setUniformTexture("fireStateSampler", fireStateTexture, 4);
+        heightMapShader.setUniform4f("fireGrid", ofVec4f(fireLeft, fireTop, firePitch, 0));
+        heightMapShader.setUniform2f("fireGridSize", ofVec2f(fireCols, fireRows));
+        //the fires are semi-transparent so that the DEM below is also visible
+        heightMapShader.setUniform4f("burningColor", ofVec4f(1, 0, 0, 175/255.0)); //Red color for burning fires
+        heightMapShader.setUniform4f("extinguishedColor", ofVec4f(0, 0, 0, 200/255.0)); //Black color for extinguished fires
+    }
     mesh.draw();
     heightMapShader.end();
     kinectProjector->unbind();
+    if (drawBurnProbabilities) {
+        ofPushStyle();
+        ofEnableAlphaBlending();
+        burnProbabilityMesh.draw();
+        ofPopStyle();
+    }
     fboProjWindow.end();
 }
 
+void SandSurfaceRenderer::setBurnProbabilities(const std::vector<float>& probabilities, int cols, int rows, const ProjCoordTable& projCoords){
+    // Every cell that burnt is a quad between its four corners in the projector coordinates of the grid, with the
+    // color of its probability (cells that never burnt are not drawn)
+    burnProbabilityCols = cols;
+    burnProbabilityCells.clear();
+    burnProbabilityMesh.clear();
+    burnProbabilityMesh.setMode(OF_PRIMITIVE_TRIANGLES);
+    for(int y=0;y<rows;y++)
+        for(int x=0;x<cols;x++)
+        {
+            float p = probabilities[y*cols+x];
+            if (p <= 0)
+                continue;
+            ofColor color = burnProbabilityMap.getColor(p);
+            color.a = 64+160*p;
+            int first = static_cast<int>(burnProbabilityMesh.getNumVertices());
+            burnProbabilityMesh.addVertex(ofPoint(projCoords.getProjCoord(x, y)));
+            burnProbabilityMesh.addVertex(ofPoint(projCoords.getProjCoord(x+1, y)));
+            burnProbabilityMesh.addVertex(ofPoint(projCoords.getProjCoord(x+1, y+1)));
+            burnProbabilityMesh.addVertex(ofPoint(projCoords.getProjCoord(x, y+1)));
+            for (int i = 0; i < 4; i++)
+                burnProbabilityMesh.addColor(color);
+            burnProbabilityMesh.addIndex(first);
+            burnProbabilityMesh.addIndex(first+1);
+            burnProbabilityMesh.addIndex(first+3);
+            
+            burnProbabilityMesh.addIndex(first+1);
+            burnProbabilityMesh.addIndex(first+2);
+            burnProbabilityMesh.addIndex(first+3);
+            burnProbabilityCells.push_back(y*cols+x);
+        }
+    drawBurnProbabilities = true;
+}
+
+void SandSurfaceRenderer::updateBurnProbabilities(const ProjCoordTable& projCoords){
+    if (!drawBurnProbabilities)
+        return;
+    std::vector<ofPoint>& vertices = burnProbabilityMesh.getVertices();
+    for (size_t i = 0; i < burnProbabilityCells.size(); i++)
+    {
+        int x = burnProbabilityCells[i] % burnProbabilityCols;
+        int y = burnProbabilityCells[i] / burnProbabilityCols;
+        vertices[4*i] = ofPoint(projCoords.getProjCoord(x, y));
+        vertices[4*i+1] = ofPoint(projCoords.getProjCoord(x+1, y));
+        vertices[4*i+2] = ofPoint(projCoords.getProjCoord(x+1, y+1));
+        vertices[4*i+3] = ofPoint(projCoords.getProjCoord(x, y+1));
+    }
+}
+
+void SandSurfaceRenderer::clearBurnProbabilities(){
+    drawBurnProbabilities = false;
+    burnProbabilityMesh.clear();
+    burnProbabilityCells.clear();
+}
+
+void SandSurfaceRenderer::setupFireStates(int cols, int rows, float left, float top, float pitch){
+    fireCols = cols;
+    fireRows = rows;
+    fireLeft = left;
+    fireTop = top;
+    firePitch = pitch;
+    fireStates.assign(cols*rows, 0);
+    // one byte per cell, read without filtering so that the states are not mixed
+    fireStateTexture.allocate(cols, rows, ofGetGLInternalFormatFromPixelFormat(OF_PIXELS_GRAY));
+    fireStateTexture.setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+    firstFireRowChanged = 0;
+    lastFireRowChanged = rows-1;
+}
+
+void SandSurfaceRenderer::setFireCellState(int x, int y, int state){
+    unsigned char& cell = fireStates[y*fireCols+x];
+    if (cell == state)
+        return;
+    cell = static_cast<unsigned char>(state);
+    firstFireRowChanged = std::min(firstFireRowChanged, y);
+    lastFireRowChanged = std::max(lastFireRowChanged, y);
+}
+
+void SandSurfaceRenderer::clearFireStates(){
+    std::fill(fireStates.begin(), fireStates.end(), 0);
+    firstFireRowChanged = 0;
+    lastFireRowChanged = fireRows-1;
+}
+
+// Uploads the rows between the first and the last one that changed, in one call
+void SandSurfaceRenderer::uploadFireStates(){
+    if (firstFireRowChanged > lastFireRowChanged || !fireStateTexture.isAllocated())
+        return;
+    const ofTextureData& data = fireStateTexture.getTextureData();
+    glBindTexture(data.textureTarget, data.textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(data.textureTarget, 0, 0, firstFireRowChanged, fireCols, lastFireRowChanged-firstFireRowChanged+1, ofGetGLFormatFromInternal(data.glInternalFormat), GL_UNSIGNED_BYTE, &fireStates[firstFireRowChanged*fireCols]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(data.textureTarget, 0);
+    firstFireRowChanged = fireRows;
+    lastFireRowChanged = -1;
+}
+
 void SandSurfaceRenderer::prepareContourLinesFbo()
 {
     contourLineFramebufferObject.begin();
@@ -32,6 +32,7 @@ General Public License for more details.
 #include "ofMain.h"
 
 #include "../KinectProjector/KinectProjector.h"
+#include "../KinectProjector/ProjCoordTable.h"
 #include "ColorMap.h"
 #endif /* defined(__GreatSand__SandSurfaceRenderer__) */
 
@@ -75,6 +76,23 @@ public:
     void drawMainWindow(float x, float y, float width, float height);
     void drawProjectorWindow();
     
+    // Burn probability overlay (FireEnsemble): one value per cell of a cols x rows grid whose corners are the points
+    // of projCoords, every cell drawn in one color of its own color map over the sandbox
+    void setBurnProbabilities(const std::vector<float>& probabilities, int cols, int rows, const ProjCoordTable& projCoords);
+    // Moves the overlay with the sand, after projCoords projected tiles again
+    void updateBurnProbabilities(const ProjCoordTable& projCoords);
+    void clearBurnProbabilities();
+    
+    // Fire overlay: state of every cell (FireSpreadEngine::CellState) of a grid covering the kinect image from
+    // (left, top) with one cell every pitch pixels, kept in a one byte per cell texture that the height map shader
+    // blends over the colors of the sand. Only the rows changed since the last frame are uploaded.
+    void setupFireStates(int cols, int rows, float left, float top, float pitch);
+    void setFireCellState(int x, int y, int state);
+    void clearFireStates();
+    void setDrawFire(bool sdrawFire){
+        drawFire = sdrawFire;
+    }
+    
     // Gui and events functions
     void setupGui();
     void onButtonEvent(ofxDatGuiButtonEvent e);
@@ -93,6 +111,7 @@ private:
     void updateRangesAndBasePlane();
     void drawSandbox();
     void prepareContourLinesFbo();
+    void uploadFireStates();
     void updateColorListColor(int i, int j);
     void populateColorList();
     bool loadSettings();
@@ -140,6 +159,21 @@ private:
 	float FilteredDepthScale,FilteredDepthOffset; // Scale and offset values to convert depth from normalized shader values to real values
     float elevationMin, elevationMax;
     
+    // Burn probability overlay
+    ColorMap burnProbabilityMap;
+    ofMesh burnProbabilityMesh;
+    int burnProbabilityCols;
+    std::vector<int> burnProbabilityCells;  // cells drawn, one quad of four vertices each
+    bool drawBurnProbabilities;
+    
+    // Fire overlay
+    ofTexture fireStateTexture;
+    std::vector<unsigned char> fireStates;
+    int fireCols, fireRows;
+    float fireLeft, fireTop, firePitch;
+    int firstFireRowChanged, lastFireRowChanged; // rows to upload, none if first > last
+    bool drawFire;
+    
     // Contourlines
     float contourLineDistance, contourLineFactor;
     bool drawContourLines; // Flag if topographic contour lines are enabled
@@ -0,0 +1,244 @@
+/***********************************************************************
+SessionJournal - binary journal of the inputs of a session.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "SessionJournal.h"
+
+#include <cstring>
+
+// "FSJ" and the version of the format
+static const uint32_t journalMagic = 0x014a5346u;
+
+SessionJournal::SessionJournal()
+:mode(OFF),
+seed(0),
+depthWidth(0),
+depthHeight(0)
+{
+}
+
+bool SessionJournal::startRecording(const std::string& path, uint32_t sseed) {
+	close();
+	out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+	seed = sseed;
+	write(journalMagic);
+	write(seed);
+	mode = RECORDING;
+	return true;
+}
+
+bool SessionJournal::startReplay(const std::string& path) {
+	close();
+	in.open(path.c_str(), std::ios::binary);
+	if (!in || read<uint32_t>() != journalMagic) {
+		in.close();
+		return false;
+	}
+	seed = read<uint32_t>();
+	mode = REPLAYING;
+	return true;
+}
+
+void SessionJournal::close() {
+	if (out.is_open())
+		out.close();
+	if (in.is_open())
+		in.close();
+	mode = OFF;
+	depthWidth = 0;
+	depthHeight = 0;
+	depth.clear();
+}
+
+void SessionJournal::writeFrame(double elapsed) {
+	write(static_cast<uint8_t>(FRAME_RECORD));
+	write(elapsed);
+}
+
+/***
+Depth record: width, height, stabilized flag, then runs of pixels until the end of the frame:
+	- number of pixels unchanged since the previous frame (uint32)
+	- number of pixels that changed (uint32), followed by their values
+The frames of the kinect grabber are filtered over time, most pixels do not change from one frame to the next.
+***/
+void SessionJournal::writeDepthFrame(const float* sdepth, int width, int height, bool stabilized) {
+	int size = width * height;
+	if (width != depthWidth || height != depthHeight) {
+		// every pixel is written for the first frame and when the size changes
+		depthWidth = width;
+		depthHeight = height;
+		depth.assign(size, 0);
+		for (int i = 0; i < size; i++)
+			depth[i] = sdepth[i] == 0 ? 1.0f : 0;
+	}
+	write(static_cast<uint8_t>(DEPTH_RECORD));
+	write(static_cast<int32_t>(width));
+	write(static_cast<int32_t>(height));
+	write(static_cast<uint8_t>(stabilized));
+
+	int i = 0;
+	while (i < size) {
+		int unchanged = i;
+		while (unchanged < size && std::memcmp(&depth[unchanged], &sdepth[unchanged], sizeof(float)) == 0)
+			unchanged++;
+		int changed = unchanged;
+		while (changed < size && std::memcmp(&depth[changed], &sdepth[changed], sizeof(float)) != 0)
+			changed++;
+		write(static_cast<uint32_t>(unchanged - i));
+		write(static_cast<uint32_t>(changed - unchanged));
+		out.write(reinterpret_cast<const char*>(sdepth + unchanged), (changed - unchanged) * sizeof(float));
+		i = changed;
+	}
+	std::memcpy(depth.data(), sdepth, size * sizeof(float));
+}
+
+void SessionJournal::writeButton(const std::string& name) {
+	write(static_cast<uint8_t>(BUTTON_RECORD));
+	writeString(name);
+}
+
+void SessionJournal::writeDropdown(const std::string& name, int parent, int child) {
+	write(static_cast<uint8_t>(DROPDOWN_RECORD));
+	writeString(name);
+	write(static_cast<int32_t>(parent));
+	write(static_cast<int32_t>(child));
+}
+
+void SessionJournal::writeSlider(const std::string& name, float value) {
+	write(static_cast<uint8_t>(SLIDER_RECORD));
+	writeString(name);
+	write(value);
+}
+
+void SessionJournal::writeKey(int key) {
+	write(static_cast<uint8_t>(KEY_RECORD));
+	write(static_cast<int32_t>(key));
+}
+
+void SessionJournal::writeMousePressed(int x, int y, int button) {
+	writeMouse(MOUSE_PRESSED_RECORD, x, y, button);
+}
+
+void SessionJournal::writeMouseDragged(int x, int y, int button) {
+	writeMouse(MOUSE_DRAGGED_RECORD, x, y, button);
+}
+
+void SessionJournal::writeMouse(RecordType type, int x, int y, int button) {
+	write(static_cast<uint8_t>(type));
+	write(static_cast<int32_t>(x));
+	write(static_cast<int32_t>(y));
+	write(static_cast<int32_t>(button));
+}
+
+void SessionJournal::writeString(const std::string& string) {
+	write(static_cast<uint32_t>(string.size()));
+	out.write(string.data(), string.size());
+}
+
+// Type of the next record without reading it, 0 at the end of the journal
+int SessionJournal::peekRecord() {
+	int type = in.peek();
+	return type == std::char_traits<char>::eof() ? 0 : type;
+}
+
+bool SessionJournal::readFrame(double& elapsed) {
+	// the events of the previous frame that were not read are skipped
+	InputEvent event;
+	while (readInputEvent(event)) {
+	}
+	if (peekRecord() == DEPTH_RECORD) {
+		int width, height;
+		bool stabilized;
+		readDepthFrame(width, height, stabilized);
+	}
+	if (peekRecord() != FRAME_RECORD) {
+		close();
+		return false;
+	}
+	read<uint8_t>();
+	elapsed = read<double>();
+	return static_cast<bool>(in);
+}
+
+bool SessionJournal::readDepthFrame(int& width, int& height, bool& stabilized) {
+	if (mode != REPLAYING || peekRecord() != DEPTH_RECORD)
+		return false;
+	read<uint8_t>();
+	width = read<int32_t>();
+	height = read<int32_t>();
+	stabilized = read<uint8_t>() != 0;
+	int size = width * height;
+	if (width != depthWidth || height != depthHeight) {
+		depthWidth = width;
+		depthHeight = height;
+		depth.assign(size, 0);
+	}
+
+	int i = 0;
+	while (i < size && in) {
+		i += static_cast<int>(read<uint32_t>());
+		int changed = static_cast<int>(read<uint32_t>());
+		if (changed > size - i)
+			break;
+		in.read(reinterpret_cast<char*>(depth.data() + i), changed * sizeof(float));
+		i += changed;
+	}
+	return static_cast<bool>(in);
+}
+
+bool SessionJournal::readInputEvent(InputEvent& event) {
+	if (mode != REPLAYING)
+		return false;
+	int type = peekRecord();
+	if (type != BUTTON_RECORD && type != DROPDOWN_RECORD && type != SLIDER_RECORD && type != KEY_RECORD &&
+		type != MOUSE_PRESSED_RECORD && type != MOUSE_DRAGGED_RECORD)
+		return false;
+	read<uint8_t>();
+	event.type = static_cast<RecordType>(type);
+	if (type == KEY_RECORD) {
+		event.key = read<int32_t>();
+	}
+	else if (type == MOUSE_PRESSED_RECORD || type == MOUSE_DRAGGED_RECORD) {
+		event.x = read<int32_t>();
+		event.y = read<int32_t>();
+		event.button = read<int32_t>();
+	}
+	else {
+		event.name = readString();
+		if (type == DROPDOWN_RECORD) {
+			event.parent = read<int32_t>();
+			event.child = read<int32_t>();
+		}
+		if (type == SLIDER_RECORD)
+			event.value = read<float>();
+	}
+	return static_cast<bool>(in);
+}
+
+std::string SessionJournal::readString() {
+	uint32_t size = read<uint32_t>();
+	std::string string;
+	if (size < (1u << 16)) {
+		string.resize(size);
+		in.read(&string[0], size);
+	}
+	return string;
+}
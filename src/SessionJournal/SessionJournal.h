@@ -0,0 +1,129 @@
+/***********************************************************************
+SessionJournal - binary journal of the inputs of a session: the seed of
+the random numbers, the time of every frame, the filtered depth frames
+of the kinect and the GUI and key events. A recorded journal is fed
+back through the same code paths of the application at full speed, to
+reproduce and profile a session offline.
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class SessionJournal {
+public:
+	enum Mode {
+		OFF = 0,
+		RECORDING = 1,
+		REPLAYING = 2
+	};
+	/***
+	Records of the journal, in the order of the session. Every frame starts with a FRAME_RECORD (time elapsed since
+	the previous frame), followed by the depth frame received in this frame if any, then by the input events.
+	***/
+	enum RecordType {
+		FRAME_RECORD = 1,
+		DEPTH_RECORD = 2,
+		BUTTON_RECORD = 3,
+		DROPDOWN_RECORD = 4,
+		SLIDER_RECORD = 5,
+		KEY_RECORD = 6,
+		MOUSE_PRESSED_RECORD = 7,
+		MOUSE_DRAGGED_RECORD = 8
+	};
+	// Input event read from the journal (the fields of its type are set)
+	struct InputEvent {
+		RecordType type;
+		std::string name;	// name of the GUI component
+		int parent, child;	// dropdown
+		float value;		// slider
+		int key;
+		int x, y, button;	// mouse, in main window coordinates
+	};
+
+	SessionJournal();
+
+	// Creates the journal file, returns false if it cannot be written
+	bool startRecording(const std::string& path, uint32_t seed);
+	// Opens a journal file, returns false if it is not a journal
+	bool startReplay(const std::string& path);
+	void close();
+
+	Mode getMode() const {
+		return mode;
+	}
+	bool isRecording() const {
+		return mode == RECORDING;
+	}
+	bool isReplaying() const {
+		return mode == REPLAYING;
+	}
+	// Seed of the random numbers of the session
+	uint32_t getSeed() const {
+		return seed;
+	}
+
+	// Recording
+	void writeFrame(double elapsed);
+	// The depth frames are stored as the pixels that changed since the previous frame
+	void writeDepthFrame(const float* depth, int width, int height, bool stabilized);
+	void writeButton(const std::string& name);
+	void writeDropdown(const std::string& name, int parent, int child);
+	void writeSlider(const std::string& name, float value);
+	void writeKey(int key);
+	void writeMousePressed(int x, int y, int button);
+	void writeMouseDragged(int x, int y, int button);
+
+	// Replay
+	// Starts the next frame, returns false at the end of the journal (the journal is then closed)
+	bool readFrame(double& elapsed);
+	// Reads the depth frame of the current frame, returns false if there is none
+	bool readDepthFrame(int& width, int& height, bool& stabilized);
+	const float* getDepthFrame() const {
+		return depth.data();
+	}
+	// Reads the next input event of the current frame, returns false when the next record is the next frame
+	bool readInputEvent(InputEvent& event);
+
+private:
+	int peekRecord();
+	void writeString(const std::string& string);
+	void writeMouse(RecordType type, int x, int y, int button);
+	std::string readString();
+	template <class T>
+	void write(const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+	template <class T>
+	T read() {
+		T value = T();
+		in.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return value;
+	}
+
+	Mode mode;
+	uint32_t seed;
+	std::ofstream out;
+	std::ifstream in;
+	int depthWidth, depthHeight;
+	std::vector<float> depth;	// last depth frame written or read
+};
@@ -47,8 +47,23 @@ bool setSecondWindowDimensions(ofGLFWWindowSettings& settings) {
 }
 
 //========================================================================
-int main() {
+int main(int argc, char* argv[]) {
 	//cout << "\nInside main function";
+
+	// "--record file" writes the inputs of the session to a journal, "--replay file" replays a recorded journal
+	SessionJournal::Mode journalMode = SessionJournal::OFF;
+	string journalPath;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (string(argv[i]) == "--record") {
+			journalMode = SessionJournal::RECORDING;
+			journalPath = argv[++i];
+		}
+		else if (string(argv[i]) == "--replay") {
+			journalMode = SessionJournal::REPLAYING;
+			journalPath = argv[++i];
+		}
+	}
+
 	ofGLFWWindowSettings settings;
 	settings.width = 1200;
 	settings.height = 600;
@@ -68,6 +83,7 @@ int main() {
 	shared_ptr<ofApp> mainApp(new ofApp);
 	ofAddListener(secondWindow->events().draw, mainApp.get(), &ofApp::drawProjWindow);
 	mainApp->projWindow = secondWindow;
+	mainApp->setJournal(journalMode, journalPath);
 		
 	ofRunApp(mainWindow, mainApp);
 	ofRunMainLoop();
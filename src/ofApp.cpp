@@ -1,939 +1,1307 @@
-/***********************************************************************
-ofApp.cpp - main openframeworks app
-
-Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
-Univeristy of Muenster, Germany
-
-Based on Magic Sand by Thomas Wolf (2016)
-
-This file is part of the project "Fire in the Sandbox".
-Guided by Junior Prof. Dr. Judith Verstegen
-
-The "Fire in the Sandbox" is free software; you can redistribute it
-and/or modify it under the terms of the GNU General Public License as
-published by the Free Software Foundation.
-
-The "Fire in the Sandbox" is distributed in the hope that it will be
-useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-General Public License for more details.
-
-***********************************************************************/
-
-#include "ofApp.h"
-
-void ofApp::setup() {
-	//cout << "\nInside ofApp::setup function";
-
-	// OF basics
-	ofSetFrameRate(10);
-	ofBackground(0);
-	ofSetVerticalSync(true);
-	ofSetLogLevel("ofThread", OF_LOG_WARNING);
-
-	// Setup kinectProjector
-	kinectProjector = std::make_shared<KinectProjector>(projWindow);
-	kinectProjector->setup(true);
-	
-	// Setup sandSurfaceRenderer
-	sandSurfaceRenderer = new SandSurfaceRenderer(kinectProjector, projWindow);
-	sandSurfaceRenderer->setup(true);
-	
-	// Retrieve variables
-	kinectRes = kinectProjector->getKinectRes();
-	projRes = ofVec2f(projWindow->getWidth(), projWindow->getHeight());
-	kinectROI = kinectProjector->getKinectROI();
-	
-	// Set width, height and alpha of ofFbos
-	// Separate Fbo for fires, house and fireman (truck)
-	fboVehicles.allocate(projRes.x, projRes.y, GL_RGBA);
-	fboHouse.allocate(projRes.x, projRes.y, GL_RGBA);
-	fboFireman.allocate(projRes.x, projRes.y, GL_RGBA);
-
-	setupGui();
-
-	// Vehicles
-	showMotherFire = false;
-
-	// initial value for the starting point of fire
-	StartX = kinectROI.getLeft();
-	StartY = kinectROI.getTop();
-
-	// initial value for the sliders
-	StartXSlider = kinectROI.getLeft();
-	StartYSlider = kinectROI.getTop();
-
-	// default option for wind
-	windSpeed = "NoWind";
-	// default option for vegetation
-	vegType = "Evergreen";
-	// default option for wind direction
-	windDirection = "North";
-
-	// initial value for check variables
-	FiremanSet = false;
-	firemanNearHouse = false;
-	showhouseWithBarrier = false;
-}
-
-void ofApp::update() {
-	//cout << "\nInside ofApp::update function";
-
-    // Call kinectProjector->update() first during the update function()
-	kinectProjector->update();
-	sandSurfaceRenderer->update();
-    
-    if (kinectProjector->isROIUpdated())
-        kinectROI = kinectProjector->getKinectROI();
-
-	spreadFire();
-
-	if (kinectProjector->isImageStabilized()) {
-	    for (auto & r : Fires){
-			//decrease the fuel availability of the burning fires by 1 in each time step
-			r.fuel = r.fuel - 1;
-			//redraw the fire when it is extinguished
-			if (r.fuel == 0) {
-				FiresToBeDrawn.push_back(r);
-			}
-	    }
-
-		//update only the new fire instances created and the instances that extinguished in this time step
-		for (auto & r : FiresToBeDrawn) {
-			r.update();
-		}
-
-		for (auto & m : Markers) {
-			m.update();
-		}
-
-		//check if the fire has reached the house (runs only until the house starts burning)
-		if (!burnHouse) {
-			for (auto & h : Houses) {
-				h.update();
-				int h_x = static_cast<int>(h.getLocation().x);
-				int h_y = static_cast<int>(h.getLocation().y);
-				float gridforHouse[16][16][2] = { 0 };
-				for (int i = -15; i <= 15; i = i+2) {
-					for (int j = -15; j <= 15; j =j+2) {
-						gridforHouse[(i+15)/2][(j+15)/2][0] = h_x + i;
-						gridforHouse[(i+15)/2][(j+15)/2][1] = h_y + j;
-					}
-				}
-				//check if house is on a burning cell
-				for (int i = 0; i < 16 & (!h.burningState); i++) {
-					for (int j = 0; j < 16 & (!h.burningState); j++) {
-						int h_temp_x = (gridforHouse[i][j][0] - kinectROI.getLeft()) / 2;
-						int h_temp_y = (gridforHouse[i][j][1] - kinectROI.getTop()) / 2;
-						if (grid[h_temp_x][h_temp_y] == 1) {
-							h.image.load("house2.png");
-							burnHouse = true;
-							h.burningState = true;
-						}
-					}
-				}
-				
-			}
-		}
-		
-		for (auto & hb : HousesWithBarrier) {
-			hb.update();
-		}
-		
-		//check if the center of fireman (truck) is on fire!
-		bool killFireman = false;
-		for (auto & fm : Firemen) {
-			fm.update();
-			int fm_x = static_cast<int>(fm.getLocation().x);
-			int fm_y = static_cast<int>(fm.getLocation().y);
-			//check if fireman is on a burning cell
-			int fm_temp_x = (fm_x - kinectROI.getLeft()) / 2;
-			int fm_temp_y = (fm_y - kinectROI.getTop()) / 2;
-			if (grid[fm_temp_x][fm_temp_y] == 1) {
-				killFireman = true;
-			}
-		}
-		if (killFireman) {
-			Firemen.clear();
-			FiremanSet = false;
-		}
-
-	    drawVehicles();
-	}
-	gui->update();
-}
-
-
-void ofApp::draw() {
-	//cout << "\nInside ofApp::draw function";
-
-	sandSurfaceRenderer->drawMainWindow(300, 30, 600, 450);//400, 20, 400, 300);
-	fboVehicles.draw(300, 30, 600, 450);
-	fboHouse.draw(300, 30, 600, 450);
-	fboFireman.draw(300, 30, 600, 450);
-	kinectProjector->drawMainWindow(300, 30, 600, 450);
-	gui->draw();
-}
-
-void ofApp::drawProjWindow(ofEventArgs &args) {
-	//cout << "\nInside ofApp::drawProjWindow function";
-
-	kinectProjector->drawProjectorWindow();
-	
-	if (!kinectProjector->isCalibrating()){
-	    sandSurfaceRenderer->drawProjectorWindow();
-	    fboVehicles.draw(0,0);
-		fboHouse.draw(0, 0);
-		fboFireman.draw(0, 0);
-	}
-}
-
-// Draw all new fire instances, extinguished instances, house/house with barrier, fireman (firetruck)
-void ofApp::drawVehicles()
-{
-	//cout << "\nInside ofApp::drawVehicles function";
-
-	/***** VEHICLE FBO ****/
-    fboVehicles.begin();
-    for (auto & r : FiresToBeDrawn){
-        r.draw();
-    }
-
-	for (auto & m : Markers) {
-		ofClear(255, 255, 255, 0);
-		m.draw();
-	}
-	fboVehicles.end();
-	
-	/***** HOUSE FBO ****/
-	fboHouse.begin();
-	for (auto & h : Houses) {
-		ofClear(255, 255, 255, 0);
-		h.draw();
-	}
-	
-	for (auto & hb : HousesWithBarrier) {
-		ofClear(255, 255, 255, 0);
-		hb.draw();
-	}
-	fboHouse.end();
-	
-	/***** FIREMAN FBO ****/
-	fboFireman.begin();
-	ofClear(255,255,255, 0);
-	for (auto & fm : Firemen) {
-		fm.draw();
-	}
-	fboFireman.end();
-    
-}
-
-// Setting up the user interface of the application - PLACED AT BOTTOM RIGHT PART OF THE INTERFACE
-void ofApp::setupGui(){
-	//cout << "\nInside ofApp::setupGui function";
-
-    // instantiate and position the gui //
-    gui = new ofxDatGui();
-
-	// set FrameRate
-	gui->addSlider("Set FrameRate", 5, 20, 10)->setPrecision(0);
-
-	// dropdown for Wind Speed (parent #0)
-	vector<string> optionsWind{ "No Wind", "Low Wind Speed", "High Wind Speed" };
-	gui->addDropdown("Options for wind", optionsWind);
-	
-	// dropdown for Wind Direction (parent #1)
-	vector<string> optionsWindDirection{ "West - East", "East - West", "South - North", "North - South" };
-	gui->addDropdown("Wind Direction", optionsWindDirection);
-
-	// dropdown for Vegetation type (parent #2)
-	vector<string> optionsVegetationType{ "Evergreen Forest", "Grasslands", "Pinus Forest" };
-	gui->addDropdown("Vegetation type", optionsVegetationType);
-
-	// Sliders to define the starting point of fire
-	gui->addLabel("Starting Point of Fire");
-	gui->addSlider("X coordinate", kinectROI.getLeft(), kinectROI.getRight(), Fires.size())->setPrecision(0);
-	gui->addSlider("Y coordinate", kinectROI.getTop(), kinectROI.getBottom(), Fires.size())->setPrecision(0);
-	
-	// Buttons
-	gui->addButton("Start");
-	gui->addButton("Add a House");
-	gui->addButton("Add Fireman");
-    gui->addButton("Reset");
-    gui->addBreak();
-    
-
-    gui->onButtonEvent(this, &ofApp::onButtonEvent);
-    gui->onToggleEvent(this, &ofApp::onToggleEvent);
-    gui->onSliderEvent(this, &ofApp::onSliderEvent);
-	gui->onDropdownEvent(this, &ofApp::onDropdownEvent);
-    gui->setLabelAlignment(ofxDatGuiAlignment::CENTER);
-    
-    gui->setPosition(ofxDatGuiAnchor::BOTTOM_RIGHT); // This should be done at the end
-	gui->setAutoDraw(false); // troubles with multiple windows drawings on Windows
-}
-
-// Button Events - runs when a button is clicked on the interface
-void ofApp::onButtonEvent(ofxDatGuiButtonEvent e){
-	//cout << "\nInside ofApp::onButtonEvent function";
-
-	/*** 
-	START BUTTON:
-	Clears all Fire vectors, markers.
-	Creates a new fire instance at the starting point selected in the slider
-	Updates the value in that location in the 2D grid to 1 (burning)
-	***/
-	if (e.target->is("Start")) {
-		Fires.clear();
-		FiresThatCanSpawn.clear();
-		FiresToBeDrawn.clear();
-		Markers.clear();
-		addNewFire(StartX, StartY);
-
-		int temp_x = (StartX - kinectROI.getLeft()) / 2;
-		int temp_y = (StartY - kinectROI.getTop()) / 2;
-		grid[temp_x][temp_y] = 1;
-	}
-
-	/***
-	RESET BUTTON:
-	Clears all vectors and fbos; Reset grid and check variables
-	***/
-    if (e.target->is("Reset")) {
-        
-		// Clear all vectors
-		Fires.clear();
-		FiresThatCanSpawn.clear();
-		FiresToBeDrawn.clear();
-		Markers.clear();
-		Houses.clear();
-		HousesWithBarrier.clear();
-		Firemen.clear();
-		
-		// Clear Fbos
-		fboVehicles.begin();
-		ofClear(255, 255, 255, 0);
-		fboVehicles.end();
-		fboHouse.begin();
-		ofClear(255, 255, 255, 0);
-		fboHouse.end();
-
-        showMotherFire = false;
-		
-		// Reset all values in the grid to 0 (not burning)
-		for (int i = 0; i < 261; i++)
-			for (int j = 0; j < 157; j++)
-				grid[i][j] = 0;
-
-		// Reset Check Variables
-		FiremanSet = false;
-		firemanNearHouse = false;
-		burnHouse = false;
-    }
-
-	/***
-	'ADD A HOUSE' BUTTON:
-	Clears Houses and HousesWithBarriers vector and adds a new house at a random location
-	***/
-	if (e.target->is("Add a House")) {
-		Houses.clear();
-		HousesWithBarrier.clear();
-		showMotherFire = false;
-		addHouse();
-	}
-
-	/***
-	'ADD FIREMAN' BUTTON:
-	Clears Firemen vector and adds a new fireman at a random location
-	***/
-	if (e.target->is("Add Fireman")) {
-		Firemen.clear();
-		addFireman();
-	}
-}
-
-// Dropdown Events - runs when an option is chosen in one of the dropdowns on the interface
-void ofApp::onDropdownEvent(ofxDatGuiDropdownEvent e) {
-	//cout << "\nInside ofApp::onDropdownEvent() function";
-	
-	/*** WIND SPEED DROPDOWN ***/
-	//No Wind
-	if (e.parent == 1 & e.child == 0) {
-		windSpeed = "NoWind";
-	}
-	//Low Wind Speed
-	if (e.parent == 1 & e.child == 1) {
-		windSpeed = "LowWind";	// Velocity = 0.42 m/s
-	}
-	//High Wind Speed
-	if (e.parent == 1 & e.child == 2) {
-		windSpeed = "HighWind";	// Velocity = 1.15 m/s
-	}
-	
-	/*** WIND DIRECTION DROPDOWN ***/
-	if (e.parent == 2 & e.child == 0) {
-		windDirection = "West";		// West to East
-	}
-	if (e.parent == 2 & e.child == 1) {
-		windDirection = "East";		// East to West
-	}
-	if (e.parent == 2 & e.child == 2) {
-		windDirection = "South";	// South to North
-	}
-	if (e.parent == 2 & e.child == 3) {
-		windDirection = "North";	// North to South
-	}
-
-	/*** VEGETATION TYPE DROPDOWN ***/
-	if (e.parent == 3 & e.child == 0) {
-		vegType = "Evergreen";
-	}
-	if (e.parent == 3 & e.child == 1) {
-		vegType = "Grassland";
-	}
-	if (e.parent == 3 & e.child == 2) {
-		vegType = "Pinus";
-	}
-}
-
-// Slider Events - runs when a slider value changes in the interface
-void ofApp::onSliderEvent(ofxDatGuiSliderEvent e){
-	//cout << "\nInside ofApp::onSliderEvent function";
-
-	// Set the number of frames (timesteps) per second
-	if (e.target->is("Set FrameRate")) {
-		ofSetFrameRate(e.value);
-	}
-
-	// Sets the starting point of fire and adds a marker when slider value changes
-	if (e.target->is("X coordinate")) {
-		StartXSlider = e.value;
-		if(Fires.size()==0)
-			addMarker(StartX, StartY);
-	}
-	if (e.target->is("Y coordinate")) {
-		StartYSlider = e.value;
-		if (Fires.size() == 0)
-			addMarker(StartX, StartY);
-	}
-}
-
-// Key Pressed Events - runs when a key is pressed on the keyboard
-// Control the movement of fireman using arrow keys (truck)
-void ofApp::keyPressed(int key) {
-	//cout << "\nInside ofApp::keyPressed function";
-	if (FiremanSet) {
-		for (auto & fm : Firemen) {
-			if ((key == OF_KEY_UP) | (key == OF_KEY_DOWN) | (key == OF_KEY_LEFT) | (key == OF_KEY_RIGHT)) {
-				
-				// Move the fireman when an arrow key is pressed
-				fm.moveFireman(key);
-
-				// Check if Fireman is near house
-				// If yes, convert the house to house with barrier
-				if (!firemanNearHouse) {
-					int x;
-					int y;
-					for (auto & h : Houses) {
-						x = static_cast<int>(h.getLocation().x);
-						y = static_cast<int>(h.getLocation().y);
-						int fm_x = static_cast<int>(fm.getLocation().x);
-						int fm_y = static_cast<int>(fm.getLocation().y);
-						
-						//check if fireman is near the House
-						for (int i = -15; (i <= 15); i++) {
-							for (int j = -15; (j <= 15); j++) {
-								if ((fm_x == (x + i)) & (fm_y == (y + j)))
-									firemanNearHouse = true;
-							}
-						}
-					}
-					if (firemanNearHouse & !showhouseWithBarrier) {
-						Houses.clear();
-						HousesWithBarrier.clear();
-						showMotherFire = false;
-						addHouseWithBarrier(x, y);
-						showhouseWithBarrier = true;
-					}
-				}
-			}
-		}
-	}
-}
-
-// Adds the first fire instance and adds it in all the Fire vectors
-void ofApp::addNewFire(float x, float y) {
-	//cout << "\nInside ofApp::addNewFire function";
-
-	ofVec2f location = ofVec2f(x, y);
-	auto r = Fire(kinectProjector, location, kinectROI, motherFire);
-	r.setup();
-	Fires.push_back(r);
-	FiresToBeDrawn.push_back(r);
-	FiresThatCanSpawn.push_back(r);
-}
-
-/***
-SPREAD FIRE FUNCTION:
-	- Considers each fire instance in the vector
-	- Checks if it has atleast one non-burning neighbour
-	- Creates new instances depending on probabilities
-***/
-void ofApp::spreadFire() {
-	
-	// to prevent calling new fires in the same timestep
-	vector<Fire> FiresAtThisTime = FiresThatCanSpawn;
-	// Clear vectors
-	FiresToBeDrawn.clear();
-	FiresThatCanSpawn.clear();
-	
-	//Loop through each fire instance in the vector
-	for (auto & r : FiresAtThisTime) {
-		
-		// runs only if the fire has one unburnt neighbour
-		if (r.numberOfBurningNeighbours != 4) {
-
-			// coordinate and elevation of the current fire instance
-			float current_x = r.getLocation().x;
-			float current_y = r.getLocation().y;
-			float elevationAtCurrentCell = kinectProjector->elevationAtKinectCoord(current_x, current_y);
-			
-			// array containing the coordinate of the four neighbouring cells
-			float neighbourhood[4][2] = { { r.getLocation().x - 2,r.getLocation().y },{ r.getLocation().x + 2,r.getLocation().y },{ r.getLocation().x,r.getLocation().y - 2 },{ r.getLocation().x,r.getLocation().y + 2 } };
-
-			for (int i = 0; i < 4; i++) {
-				
-				// check if the coordinate falls outside the sandbox
-				if (neighbourhood[i][0]<kinectROI.getLeft() || neighbourhood[i][0]>kinectROI.getRight() || neighbourhood[i][1]<kinectROI.getTop() || neighbourhood[i][1]>kinectROI.getBottom()) {
-					//cout << "\n Point out of bounds! Fire instance not created!";
-				}
-				
-				// run this code when the new cell is inside sandbox
-				else {
-					// convert to grid coordinates
-					int temp_x = (neighbourhood[i][0] - kinectROI.getLeft()) / 2;
-					int temp_y = (neighbourhood[i][1] - kinectROI.getTop()) / 2;
-					
-					// spread fire only if the fire is still burning (extinguished fires cannot spread)
-					if ((r.fuel > 0) & (grid[temp_x][temp_y]<2)) {	
-						
-						// check if the new cell is inside/outside water
-						float elevationAtNewCell = kinectProjector->elevationAtKinectCoord(neighbourhood[i][0], neighbourhood[i][1]);
-						bool newCellInsideWater = (elevationAtNewCell < 0);
-						
-						// check if the cell is already burning
-						bool alreadyBurning = grid[temp_x][temp_y] == 1;
-
-						// Calculate slope
-						// Reference: http://geology.isu.edu/wapi/geostac/Field_Exercise/topomaps/slope_calc.htm
-						float elevationChange = elevationAtNewCell - elevationAtCurrentCell; //+ve : uphill; -ve: downhill
-						float horizontalDistance = sqrt(pow((neighbourhood[i][0] - current_x), 2) + pow((neighbourhood[i][1] - current_y), 2));
-						float slope = (elevationChange / horizontalDistance) * 100;
-
-						// Apply slope, wind and vegetation effects
-						bool probToCatchFire = Effects(neighbourhood[i][0], neighbourhood[i][1], current_x, current_y, slope);
-						
-						// If the cell is on land, not already burning and satisfies all the rules in Effects function, create a new fire instance
-						if (!newCellInsideWater & !alreadyBurning & probToCatchFire) {
-							// create new fire instance
-							ofVec2f newLocation = ofVec2f(neighbourhood[i][0], neighbourhood[i][1]);
-							auto newFire = Fire(kinectProjector, newLocation, kinectROI, motherFire);
-							newFire.setup();
-							
-							// update the grid
-							grid[temp_x][temp_y] = 1;
-
-							// add the new fire instance to the vectors
-							Fires.push_back(newFire);
-							FiresToBeDrawn.push_back(newFire);
-							FiresThatCanSpawn.push_back(newFire);
-
-							// update the number of burning neighbours of the fire instance
-							r.numberOfBurningNeighbours = r.numberOfBurningNeighbours + 1;
-						}
-					}
-					else {
-						int temp_x = (current_x - kinectROI.getLeft()) / 2;
-						int temp_y = (current_y - kinectROI.getTop()) / 2;
-						grid[temp_x][temp_y] = 2;
-					}
-				}
-			}
-			//update the number of burning neighbours
-			int counter = 0;
-			for (int i = 0; i < 4; i++) {
-				int temp_x = (neighbourhood[i][0] - kinectROI.getLeft()) / 2;
-				int temp_y = (neighbourhood[i][1] - kinectROI.getTop()) / 2;
-				if (grid[temp_x][temp_y] == 1)
-					counter++;
-			}
-			r.numberOfBurningNeighbours = counter;
-		}
-
-		//check if the Fire still has unburnt neighbours and if it is still burning
-		if ((r.numberOfBurningNeighbours != 4) & (r.fuel>0)) {
-			FiresThatCanSpawn.push_back(r);
-		}
-	}
-}
-
-/***
-PROBABILITIES FOR FIRE SPREAD BASED ON WIND AND SLOPE
-Reference:
-A Qualitative comparison of fire spread models incorporating wind and slope effects,
-Weise and Biging, 
-Forest Science 43.2 (1997): 170 - 180
-***/
-float ofApp::windAndSlopeEffects(float new_x, float new_y, float current_x, float current_y, float slope) {
-
-	float probToCatchFire_WS = 0;
-
-	// Cell in heading direction - wind supports fire spread
-	if (headingDirection(new_x, new_y, current_x, current_y)) {
-		if (slope > 30) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 100;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 23.32;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 23.32;
-		}
-		else if ((slope > 15) & (slope <= 30)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 76.63;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 18.42;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 6.10;
-		}
-		else if ((slope >= 0) & (slope <= 15)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 63.6;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 15.6;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 5.26;
-		}
-		else if ((slope > -15) & (slope < 0)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 42.0;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 9.9;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 4.9;
-		}
-		else if ((slope > -30) & (slope < -15)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 33.4;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 7.1;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 5.4;
-		}
-		else if (slope < -30) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 36.96;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 8.24;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 2.55;
-		}
-	}
-	// Cell in backing direction - wind doesnt support fire spread
-	else if (backingDirection(new_x, new_y, current_x, current_y)) {
-		if (slope > 30) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 1.1;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 18.3;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 23.32;
-		}
-		else if ((slope > 15) & (slope <= 30)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 2.0;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 5.5;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 6.10;
-		}
-		else if ((slope >= 0) & (slope <= 15)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 2.22;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 4.7;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 5.26;
-		}
-		else if ((slope > -15) & (slope < 0)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 2.02;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 3.2;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 4.9;
-		}
-		else if ((slope > -30) & (slope < -15)) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 1.6;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 2.7;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 5.4;
-		}
-		else if (slope < -30) {
-			if (windSpeed == "HighWind")
-				probToCatchFire_WS = 2.6;
-			else if (windSpeed == "LowWind")
-				probToCatchFire_WS = 2.3;
-			else if (windSpeed == "NoWind")
-				probToCatchFire_WS = 2.55;
-		}
-	}
-	// Cells perpendicular to wind direction - no wind effects
-	else if (checkSameDirection(new_x, new_y, current_x, current_y)) {
-		if (slope > 30)
-			probToCatchFire_WS = 23.32;
-		else if ((slope > 15) & (slope <= 30))
-			probToCatchFire_WS = 6.10;
-		else if ((slope >= 0) & (slope <= 15))
-			probToCatchFire_WS = 5.26;
-		else if ((slope > -15) & (slope < 0))
-			probToCatchFire_WS = 4.9;
-		else if ((slope > -30) & (slope < -15))
-			probToCatchFire_WS = 5.4;
-		else if (slope < -30)
-			probToCatchFire_WS = 2.55;
-	}
-
-	return probToCatchFire_WS;
-}
-
-/***
-MULTIPYING FACTORS FOR FIRE SPREAD BASED ON VEGETATION TYPE
-Reference:
-Chapter 4 - "Fire hazard and flammability of European forest types" in the book "Post-fire management and restoration of southern European forests".
-Xanthopoulos, Gavriil, Carlo Calfapietra, and Paulo Fernandes,
-Springer Netherlands (2012): 79-92.
-***/
-float ofApp::vegetationEffect(float probFromSlopeWind) {
-	float probFromSlopeWindVeg = 0;
-	if (vegType == "Evergreen") {
-		probFromSlopeWindVeg = probFromSlopeWind;
-	}
-	else if (vegType == "Grassland") {
-		probFromSlopeWindVeg = probFromSlopeWind * 1.4 ;
-	}
-	else if (vegType == "Pinus") {
-		probFromSlopeWindVeg = probFromSlopeWind * 1.8;
-	}
-	
-	return probFromSlopeWindVeg;
-}
-
-// Function that applies wind, slope and vegetation effects
-bool ofApp::Effects(float new_x, float new_y, float current_x, float current_y, float slope) {
-	float prob = windAndSlopeEffects(new_x, new_y, current_x, current_y, slope);
-	prob = vegetationEffect(prob);
-
-	float randomVal = ofRandom(0, 100);
-	bool CatchFire = (randomVal < prob);
-
-	return CatchFire;
-}
-
-// Returns true if the new cell is in heading direction from the current cell; else false
-bool ofApp::headingDirection(float new_x, float new_y, float current_x, float current_y) {
-	if (windDirection == "East")
-		return (new_x > current_x);
-	else if (windDirection == "West")
-		return (new_x < current_x);
-	else if (windDirection == "North")
-		return (new_y < current_y);
-	else if (windDirection == "South")
-		return (new_y > current_y);
-}
-
-// Returns true if the new cell is in backing direction from the current cell; else false
-bool ofApp::backingDirection(float new_x, float new_y, float current_x, float current_y) {
-	if (windDirection == "East")
-		return (new_x < current_x);
-	else if (windDirection == "West")
-		return (new_x > current_x);
-	else if (windDirection == "North")
-		return (new_y > current_y);
-	else if (windDirection == "South")
-		return (new_y < current_y);
-}
-
-// Returns true if the new cell is perpendicular to the direction of wind with respect to the current cell; else false
-bool ofApp::checkSameDirection(float new_x, float new_y, float current_x, float current_y) {
-	if (windDirection == "East" || windDirection == "West") {
-		return (new_x == current_x);
-	}
-	else if (windDirection == "North" || windDirection == "South") {
-		return (new_y == current_y);
-	}
-}
-
-// Marker for showing the staring location on the display
-void ofApp::addMarker(int x, int y) {
-	//cout << "\nInside ofApp::addMarker function";
-
-	if (setMarkerLocation(kinectROI, false)) {
-		addNewMarker(StartXSlider, StartYSlider);
-	}
-}
-
-// Set the location of the marker and checks if marker is on water
-bool ofApp::setMarkerLocation(ofRectangle area, bool liveInWater) {
-	//cout << "\nInside ofApp::setMarkerLocation function";
-
-	float x = StartXSlider;
-	float y = StartYSlider;
-	bool insideWater = kinectProjector->elevationAtKinectCoord(x, y) < 0;
-	if ((insideWater && liveInWater) || (!insideWater && !liveInWater)) {
-		StartX = x;
-		StartY = y;
-	}
-	else {
-		cout << "\nCannot start fire on water!!";
-		StartX = kinectROI.getLeft();
-		StartY = kinectROI.getTop();
-	}
-	return true;
-}
-
-// add a new marker
-void ofApp::addNewMarker(float x, float y) {
-	//cout << "\nInside ofApp::addNewMarker function";
-	Markers.clear();
-	ofVec2f location = ofVec2f(x, y);
-	cout << "\n" << (kinectProjector->elevationAtKinectCoord(x, y));
-	auto m = Marker(kinectProjector, location, kinectROI, motherFire);
-	m.setup();
-	Markers.push_back(m);
-}
-
-// Adds a house at a random position on land
-void ofApp::addHouse() {
-	//cout << "\nInside ofApp::addHouse function";
-	float gridForHouse[31][31][2] = {0};
-	ofVec2f location;
-	bool HouseSet = false;
-	while (!HouseSet) {
-		float x = ofRandom((kinectROI.getLeft() + 10), (kinectROI.getRight() - 10)); // +/-10 so that the house is not put on the borders
-		float y = ofRandom((kinectROI.getTop() + 10), (kinectROI.getBottom() - 10));
-		bool HouseInWater = false;
-		//to create grid of locations surrounding the house
-		for (int i = -15; (i <= 15) & (!HouseInWater); i++) {
-			for (int j = -15; (j <= 15) & (!HouseInWater); j++) {
-					gridForHouse[i+15][j+15][0] = x + i;
-					gridForHouse[i+15][j+15][1] = y + j;
-					if (kinectProjector->elevationAtKinectCoord(gridForHouse[i+15][j+15][0], gridForHouse[i+15][j+15][1]) < 0)
-						HouseInWater = true;
-			}
-		}
-		if (!HouseInWater ) {
-			location = ofVec2f(x, y);
-			HouseSet = true;
-		}
-	}
-	auto h = House(kinectProjector, location, kinectROI, motherFire);
-	h.setup();
-	Houses.push_back(h);
-	burnHouse = false;
-}
-
-// Adds a house with barrier at the location of the house (thus converting house to house with barrier)
-bool ofApp::addHouseWithBarrier(float h_x, float h_y) {
-	//cout << "\nInside addHouseWithBarrier() function";
-
-	ofVec2f location = ofVec2f(h_x, h_y);
-	
-	auto h = houseWithBarrier(kinectProjector, location, kinectROI, motherFire);
-	h.setup();
-	HousesWithBarrier.push_back(h);
-
-	//set value of 3 in the 2D grid for locations of the house with barrier
-	int house_x = (h.getLocation().x - kinectROI.getLeft()) / 2;
-	int house_y = (h.getLocation().y - kinectROI.getLeft()) / 2;
-	for (int i = -15; i <= 15; i++) {
-		for (int j = -15; j <= 15; j++) {
-			grid[i + house_x][j + house_y] = 3;
-		}
-	}
-	return true;
-}
-
-// Adds a fireman at a random location on an unburnt/extinguished cell on land
-void ofApp::addFireman() {
-	//cout << "\nInside ofApp::addFireman function";
-	FiremanSet = false;
-	
-	// set a random location for fireman
-	ofVec2f location;
-	while (!FiremanSet) {
-		float x = ofRandom((kinectROI.getLeft() + 10), (kinectROI.getRight() - 10)); // +/-10 so that the Fireman is not put on the borders
-		float y = ofRandom((kinectROI.getTop() + 10), (kinectROI.getBottom() - 10));
-		int temp_x = (x - kinectROI.getLeft()) / 2;
-		int temp_y = (y - kinectROI.getLeft()) / 2;
-
-		bool FiremanInWater = false;
-		bool FiremanOnFire = false;
-		if (kinectProjector->elevationAtKinectCoord(x, y) < 0)
-			FiremanInWater = true;
-		if (grid[temp_x][temp_y] == 1)
-			FiremanOnFire = true;
-		if (!FiremanInWater & !FiremanOnFire) {
-			location = ofVec2f(x, y);
-			FiremanSet = true;
-		}
-	}
-	auto fm = Fireman(kinectProjector, location, kinectROI, motherFire);
-	fm.setup();
-	Firemen.push_back(fm);
-}
-
-void ofApp::onToggleEvent(ofxDatGuiToggleEvent e) {
-}
-
-void ofApp::keyReleased(int key) {
-	//cout << "\nInside ofApp::keyReleased function";
-}
-
-void ofApp::mouseMoved(int x, int y) {
-	//cout << "\nInside ofApp::mouseMoved function";
-}
-
-void ofApp::mouseDragged(int x, int y, int button) {
-	//cout << "\nInside ofApp::mouseDragged function";
-}
-
-void ofApp::mousePressed(int x, int y, int button) {
-	//cout << "\nInside ofApp::mousePressed function";
-}
-
-void ofApp::mouseReleased(int x, int y, int button) {
-	//cout << "\nInside ofApp::mouseReleased function";
-}
-
-void ofApp::mouseEntered(int x, int y) {
-	//cout << "\nInside ofApp::mouseEntered function";
-}
-
-void ofApp::mouseExited(int x, int y) {
-	//cout << "\nInside ofApp::mouseExited function";
-}
-
-void ofApp::windowResized(int w, int h) {
-	//cout << "\nInside ofApp::windowResized function";
-}
-
-void ofApp::gotMessage(ofMessage msg) {
-	//cout << "\nInside ofApp::gotMessage function";
-}
-
-void ofApp::dragEvent(ofDragInfo dragInfo) {
-	//cout << "\nInside ofApp::dragEvent function";
+/***********************************************************************
+ofApp.cpp - main openframeworks app
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+Based on Magic Sand by Thomas Wolf (2016)
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#include "ofApp.h"
+
+void ofApp::setup() {
+	//cout << "\nInside ofApp::setup function";
+
+	// OF basics
+	// The projector and the GUI run at the refresh rate of the screens, the speed of the fire is set by fireClock
+	ofSetFrameRate(60);
+	ofBackground(0);
+	ofSetVerticalSync(true);
+	ofSetLogLevel("ofThread", OF_LOG_WARNING);
+
+	// Setup kinectProjector
+	kinectProjector = std::make_shared<KinectProjector>(projWindow);
+	kinectProjector->setup(true);
+
+	// Journal of the session, the houses and firemen are placed and the fire spreads with the random numbers of its seed
+	if (journalMode == SessionJournal::RECORDING && !journal.startRecording(journalPath, static_cast<uint32_t>(ofGetSystemTimeMicros())))
+		ofLogError("ofApp") << "setup(): cannot record the session in " << journalPath;
+	if (journalMode == SessionJournal::REPLAYING && !journal.startReplay(journalPath))
+		ofLogError("ofApp") << "setup(): cannot replay the session of " << journalPath;
+	if (journal.getMode() != SessionJournal::OFF) {
+		ofSeedRandom(journal.getSeed());
+		fireEngine.setSeed(journal.getSeed());
+	}
+	if (journal.isReplaying()) {
+		// the recorded frame times drive the model, the frames run as fast as possible
+		ofSetFrameRate(0);
+		ofSetVerticalSync(false);
+	}
+	kinectProjector->setJournal(&journal);
+	
+	// Setup sandSurfaceRenderer
+	sandSurfaceRenderer = new SandSurfaceRenderer(kinectProjector, projWindow);
+	sandSurfaceRenderer->setup(true);
+	
+	// Retrieve variables
+	kinectRes = kinectProjector->getKinectRes();
+	projRes = ofVec2f(projWindow->getWidth(), projWindow->getHeight());
+	kinectROI = kinectProjector->getKinectROI();
+	
+	// One target for the fire perimeters, markers, houses, houses with barrier and firemen (truck), in this order
+	vehicleLayers.setup(projRes.x, projRes.y);
+	vehicleLayers.addLayer("perimeters", [this]() {
+		drawFirePerimeters();
+	});
+	vehicleLayers.addLayer("markers", [this]() {
+		for (auto & m : Markers)
+			m.draw();
+	});
+	vehicleLayers.addLayer("houses", [this]() {
+		for (auto & h : Houses)
+			h.draw();
+	});
+	vehicleLayers.addLayer("housesWithBarrier", [this]() {
+		for (auto & hb : HousesWithBarrier)
+			hb.draw();
+	});
+	vehicleLayers.addLayer("firemen", [this]() {
+		for (auto & fm : Firemen)
+			fm.draw();
+	});
+
+	setupGui();
+
+	// Vehicles
+	showMotherFire = false;
+
+	// initial value for the starting point of fire
+	StartX = kinectROI.getLeft();
+	StartY = kinectROI.getTop();
+
+	// initial value for the sliders
+	StartXSlider = kinectROI.getLeft();
+	StartYSlider = kinectROI.getTop();
+
+	// Setup the fire spread model on the grid covering the kinect ROI
+	fireCellPitch = 2;
+	adaptiveFireGrid = false;
+	coarseElevationOutdated = false;
+	burnProbabilitiesOutdated = false;
+	ensembleRuns = 0;
+	showArrivalTime = false;
+	arrivalTime = 0;
+	fireRewound = false;
+	rewindSeconds = 0;
+	fireHistory.setCapacity(historySeconds * 60);
+	fuelMap.assign(static_cast<int>(kinectRes.x) * static_cast<int>(kinectRes.y), FireSpreadEngine::EVERGREEN);
+	fuelMapImage.allocate(kinectRes.x, kinectRes.y, OF_IMAGE_COLOR_ALPHA);
+	updateFuelMapImage(ofRectangle(0, 0, kinectRes.x, kinectRes.y));
+	paintFuelModel = -1;
+	showFirePerimeters = false;
+	setupFireGrid();
+
+	// default option for wind
+	fireEngine.setWindSpeed(FireSpreadEngine::NO_WIND);
+	// default option for vegetation
+	fireEngine.setVegetationType(FireSpreadEngine::EVERGREEN);
+	// default option for wind direction
+	fireEngine.setWindDirection(FireSpreadEngine::NORTH);
+
+	// initial value for check variables
+	FiremanSet = false;
+	firemanNearHouse = false;
+	showhouseWithBarrier = false;
+	burnHouse = false;
+	houseBurnTick = -1;
+}
+
+void ofApp::update() {
+	//cout << "\nInside ofApp::update function";
+
+	// Time since the previous frame, read from the journal when a session is replayed
+	double frameTime = ofGetLastFrameTime();
+	if (journal.isReplaying()) {
+		if (!journal.readFrame(frameTime)) {
+			ofLogNotice("ofApp") << "update(): end of the replayed session";
+			ofExit();
+			return;
+		}
+	}
+	else if (journal.isRecording()) {
+		journal.writeFrame(frameTime);
+	}
+
+    // Call kinectProjector->update() first during the update function()
+	kinectProjector->update();
+    
+    if (kinectProjector->isROIUpdated()) {
+        kinectROI = kinectProjector->getKinectROI();
+        setupFireGrid();
+    }
+
+	// The projector coordinates of the fire grid are only projected again in the tiles where the sand moved
+	if (kinectProjector->isCalibrationUpdated())
+		fireProjCoords.setOutdated();
+	if ((kinectProjector->isDepthFrameUpdated() || kinectProjector->isCalibrationUpdated()) && fireProjCoords.update(*kinectProjector) > 0)
+		sandSurfaceRenderer->updateBurnProbabilities(fireProjCoords);
+
+	// The elevation and slopes of the fire grid are only recomputed when the depth image changes
+	if (kinectProjector->isDepthFrameUpdated() || kinectProjector->isROIUpdated() || kinectProjector->isBasePlaneUpdated() || kinectProjector->isCalibrationUpdated())
+		fireElevationOutdated = true;
+
+	if (kinectProjector->isImageStabilized()) {
+		// Run the time steps of the fire spread model that are due since the last frame on the current topography
+		// (on the adaptive grid, only where the fire can spread before the next depth frame)
+		if (fireElevationOutdated && adaptiveFireGrid && !showArrivalTime) {
+			refineFireGrid();
+			updateRefinedFireElevation(fireAdaptiveGrid.getRefinedBlocks());
+			fireElevationOutdated = false;
+			coarseElevationOutdated = true;
+		}
+		else if (fireElevationOutdated) {
+			updateFireElevation();
+		}
+		if (showArrivalTime) {
+			drawArrivalTime();
+		}
+		else if (!fireRewound) {
+			int ticks = fireClock.advance(frameTime);
+			bool fireRunning = ticks > 0 && fireEngine.getNumberOfBurningCells() > 0;
+			refineFireGrid();
+			for (int i = 0; i < ticks; i++) {
+				fireEngine.step();
+				fireStatisticsLog.append(fireEngine);
+				refineFireGrid();
+			}
+			if (fireRunning)
+				recordFireSnapshot();
+		}
+
+		for (auto & m : Markers) {
+			m.update(fireProjCoords);
+		}
+
+		//check if the fire has reached the house (runs only until the house starts burning)
+		if (!burnHouse) {
+			for (auto & h : Houses) {
+				h.update(fireProjCoords);
+				int h_x = static_cast<int>(h.getLocation().x);
+				int h_y = static_cast<int>(h.getLocation().y);
+				float gridforHouse[16][16][2] = { 0 };
+				for (int i = -15; i <= 15; i = i+2) {
+					for (int j = -15; j <= 15; j =j+2) {
+						gridforHouse[(i+15)/2][(j+15)/2][0] = h_x + i;
+						gridforHouse[(i+15)/2][(j+15)/2][1] = h_y + j;
+					}
+				}
+				//check if house is on a burning cell
+				for (int i = 0; i < 16 & (!h.burningState); i++) {
+					for (int j = 0; j < 16 & (!h.burningState); j++) {
+						int h_temp_x = fireGrid.getCellX(gridforHouse[i][j][0]);
+						int h_temp_y = fireGrid.getCellY(gridforHouse[i][j][1]);
+						if (getFireCellState(h_temp_x, h_temp_y) == FireSpreadEngine::BURNING) {
+							h.sprite = SpriteAtlas::BURNING_HOUSE;
+							vehicleLayers.setDirty(h.getBounds());
+							burnHouse = true;
+							houseBurnTick = fireEngine.getTick();
+							h.burningState = true;
+						}
+					}
+				}
+				
+			}
+		}
+		
+		for (auto & hb : HousesWithBarrier) {
+			hb.update(fireProjCoords);
+		}
+		
+		//check if the center of fireman (truck) is on fire!
+		bool killFireman = false;
+		for (auto & fm : Firemen) {
+			fm.update(fireProjCoords);
+			int fm_x = static_cast<int>(fm.getLocation().x);
+			int fm_y = static_cast<int>(fm.getLocation().y);
+			//check if fireman is on a burning cell
+			int fm_temp_x = fireGrid.getCellX(fm_x);
+			int fm_temp_y = fireGrid.getCellY(fm_y);
+			if (getFireCellState(fm_temp_x, fm_temp_y) == FireSpreadEngine::BURNING) {
+				killFireman = true;
+			}
+		}
+		if (killFireman) {
+			Firemen.clear();
+			FiremanSet = false;
+		}
+
+	    drawVehicles();
+	}
+
+	// Burn probabilities, drawn once every run of the ensemble is done
+	if (burnProbabilitiesOutdated && fireEnsemble.isFinished()) {
+		sandSurfaceRenderer->setBurnProbabilities(fireEnsemble.getBurnProbabilities(), fireGrid.getCols(), fireGrid.getRows(), fireProjCoords);
+		burnProbabilitiesOutdated = false;
+	}
+
+	// The sandbox is drawn once the fire states of this frame are known, the fire is blended in its shader
+	sandSurfaceRenderer->update();
+	// during a replay the GUI only changes with the events of the journal, not with the mouse
+	if (journal.isReplaying())
+		replayInputEvents();
+	else
+		gui->update();
+}
+
+
+void ofApp::draw() {
+	//cout << "\nInside ofApp::draw function";
+
+	sandSurfaceRenderer->drawMainWindow(mainView.x, mainView.y, mainView.width, mainView.height);//400, 20, 400, 300);
+	vehicleLayers.draw(mainView.x, mainView.y, mainView.width, mainView.height);
+	kinectProjector->drawMainWindow(mainView.x, mainView.y, mainView.width, mainView.height);
+	if (paintFuelModel >= 0)
+		fuelMapImage.draw(mainView.x, mainView.y, mainView.width, mainView.height);
+	drawStatistics();
+	gui->draw();
+}
+
+void ofApp::drawProjWindow(ofEventArgs &args) {
+	//cout << "\nInside ofApp::drawProjWindow function";
+
+	kinectProjector->drawProjectorWindow();
+	
+	if (!kinectProjector->isCalibrating()){
+	    sandSurfaceRenderer->drawProjectorWindow();
+		vehicleLayers.draw(0, 0);
+	}
+}
+
+// Outlines of the burn scar and of the active front, their points are read from the projector coordinates of the fire grid.
+// Returns false if the outlines did not change (their points may have moved with the sand).
+bool ofApp::updateFirePerimeters() {
+	bool changed = firePerimeter.update(fireEngine);
+	perimeterProjCoords.clear();
+	for (int layer = 0; layer < FirePerimeter::numberOfLayers; layer++) {
+		for (auto & point : firePerimeter.getPoints(static_cast<FirePerimeter::Layer>(layer)))
+			perimeterProjCoords.push_back(fireProjCoords.getProjCoord(fireGrid.getLeft() + point.x * fireGrid.getPitch(), fireGrid.getTop() + point.y * fireGrid.getPitch()));
+	}
+
+	int first = 0;
+	for (int layer = 0; layer < FirePerimeter::numberOfLayers; layer++) {
+		const vector<int>& starts = firePerimeter.getPolylineStarts(static_cast<FirePerimeter::Layer>(layer));
+		perimeterPolylines[layer].resize(starts.size() - 1);
+		for (size_t i = 0; i + 1 < starts.size(); i++) {
+			ofPolyline& polyline = perimeterPolylines[layer][i];
+			polyline.clear();
+			for (int point = first + starts[i]; point < first + starts[i + 1]; point++)
+				polyline.addVertex(perimeterProjCoords[point].x, perimeterProjCoords[point].y);
+			polyline.close();
+		}
+		first += starts.back();
+	}
+	return changed;
+}
+
+// Outlines updated last, while they are shown
+void ofApp::drawFirePerimeters() {
+	if (!showFirePerimeters || showArrivalTime)
+		return;
+	ofSetLineWidth(3);
+	ofSetColor(70, 40, 20);
+	for (auto & polyline : perimeterPolylines[FirePerimeter::SCAR])
+		polyline.draw();
+	ofSetColor(255, 90, 0);
+	for (auto & polyline : perimeterPolylines[FirePerimeter::FRONT])
+		polyline.draw();
+	ofSetLineWidth(1);
+	ofSetColor(255);
+}
+
+// Statistics of the fire below the sandbox, read from the counters of the engine
+void ofApp::drawStatistics() {
+	float ticksPerSecond = fireClock.getTicksPerSecond();
+	string statistics = "Burnt area: " + ofToString(fireEngine.getNumberOfBurntCells()) + " cells ("
+		+ ofToString(fireEngine.getNumberOfBurningCells()) + " burning)\n";
+	statistics += "Front length: " + ofToString(fireEngine.getFrontLength()) + " cells\n";
+	statistics += "Rate of spread: " + ofToString(fireEngine.getRateOfSpread() * ticksPerSecond, 2) + " cells/s\n";
+	statistics += "Time to house: ";
+	if (houseBurnTick >= 0)
+		statistics += ofToString(houseBurnTick) + " time steps (" + ofToString(houseBurnTick / ticksPerSecond, 1) + " s)";
+	else
+		statistics += Houses.empty() ? "no house" : "not reached";
+	if (adaptiveFireGrid)
+		statistics += "\nRefined grid: " + ofToString(fireAdaptiveGrid.getNumberOfRefinedCells()) + " of " + ofToString(fireGrid.getCols() * fireGrid.getRows()) + " cells";
+	ofDrawBitmapStringHighlight(statistics, mainView.x, mainView.getBottom() + 24);
+}
+
+// Draw all new fire instances, extinguished instances, house/house with barrier, fireman (firetruck)
+void ofApp::drawVehicles()
+{
+	//cout << "\nInside ofApp::drawVehicles function";
+
+	// the cells that caught fire, were extinguished or were restored since the last frame are copied to the
+	// fire state texture of the sandbox, drawn by its shader unless the perimeters are shown instead
+	for (int index : fireEngine.getChangedCells())
+		sandSurfaceRenderer->setFireCellState(fireEngine.getCellX(index), fireEngine.getCellY(index), fireEngine.getCellState(index));
+	fireEngine.clearChangedCells();
+	sandSurfaceRenderer->setDrawFire(!showFirePerimeters || showArrivalTime);
+
+	/***** VEHICLE LAYERS ****/
+	// bounds of the objects of every layer: the layers are only drawn again where an object appeared, moved or
+	// disappeared (and where the perimeters changed)
+	layerBounds.clear();
+	if (showFirePerimeters && !showArrivalTime) {
+		bool perimetersChanged = updateFirePerimeters();
+		for (int layer = 0; layer < FirePerimeter::numberOfLayers; layer++) {
+			for (auto & polyline : perimeterPolylines[layer]) {
+				// lines 3 pixels wide
+				ofRectangle bounds = polyline.getBoundingBox();
+				bounds.set(bounds.x - 2, bounds.y - 2, bounds.width + 4, bounds.height + 4);
+				layerBounds.push_back(bounds);
+				if (perimetersChanged)
+					vehicleLayers.setDirty(bounds);
+			}
+		}
+	}
+	vehicleLayers.setLayerBounds("perimeters", layerBounds);
+
+	layerBounds.clear();
+	for (auto & m : Markers)
+		layerBounds.push_back(m.getBounds());
+	vehicleLayers.setLayerBounds("markers", layerBounds);
+
+	layerBounds.clear();
+	for (auto & h : Houses)
+		layerBounds.push_back(h.getBounds());
+	vehicleLayers.setLayerBounds("houses", layerBounds);
+
+	// a separate layer, a house replaced by a house with barrier at the same place is drawn again
+	layerBounds.clear();
+	for (auto & hb : HousesWithBarrier)
+		layerBounds.push_back(hb.getBounds());
+	vehicleLayers.setLayerBounds("housesWithBarrier", layerBounds);
+
+	layerBounds.clear();
+	for (auto & fm : Firemen)
+		layerBounds.push_back(fm.getBounds());
+	vehicleLayers.setLayerBounds("firemen", layerBounds);
+
+	vehicleLayers.update();
+}
+
+// Setting up the user interface of the application - PLACED AT BOTTOM RIGHT PART OF THE INTERFACE
+void ofApp::setupGui(){
+	//cout << "\nInside ofApp::setupGui function";
+
+    // instantiate and position the gui //
+    gui = new ofxDatGui();
+
+	// set the speed of the fire, in time steps per second (independent of the frame rate)
+	gui->addSlider("Ticks per second", 1, 200, 10)->setPrecision(0);
+
+	// dropdown for Wind Speed (parent #0)
+	vector<string> optionsWind{ "No Wind", "Low Wind Speed", "High Wind Speed" };
+	gui->addDropdown("Options for wind", optionsWind);
+	
+	// dropdown for Wind Direction (parent #1)
+	vector<string> optionsWindDirection{ "West - East", "East - West", "South - North", "North - South" };
+	gui->addDropdown("Wind Direction", optionsWindDirection);
+
+	// dropdown for Vegetation type (parent #2)
+	vector<string> optionsVegetationType{ "Evergreen Forest", "Grasslands", "Pinus Forest" };
+	gui->addDropdown("Vegetation type", optionsVegetationType);
+
+	// dropdown for the size of the cells of the fire grid, in kinect pixels (parent #4)
+	vector<string> optionsCellSize{ "1 px cells", "2 px cells", "4 px cells", "Adaptive 1 px cells" };
+	gui->addDropdown("Cell size", optionsCellSize);
+
+	// dropdown to paint the fuel map with the mouse on the main window (parent #5)
+	vector<string> optionsFuelMap{ "Hide fuel map", "Paint Evergreen Forest", "Paint Grasslands", "Paint Pinus Forest", "Paint firebreak" };
+	gui->addDropdown("Fuel map", optionsFuelMap);
+	gui->addButton("Load fuel map");
+
+	// any wind (the wind dropdowns set the values of their options) and neighbours the fire spreads to
+	gui->addSlider("Wind angle", 0, 360, 270)->setPrecision(0);
+	gui->addSlider("Wind speed (m/s)", 0, 1.5, 0)->setPrecision(2);
+	gui->addButton("Neighbours")->setLabel("Neighbours: 4");
+
+	// Sliders to define the starting point of fire
+	gui->addLabel("Starting Point of Fire");
+	gui->addSlider("X coordinate", kinectROI.getLeft(), kinectROI.getRight(), 0)->setPrecision(0);
+	gui->addSlider("Y coordinate", kinectROI.getTop(), kinectROI.getBottom(), 0)->setPrecision(0);
+	
+	// Buttons
+	gui->addButton("Start");
+	gui->addButton("Burn probability");
+	gui->addButton("Arrival time");
+	gui->addSlider("Time", 0, 1000, 0)->setPrecision(0);
+	gui->addSlider("Rewind (s)", 0, historySeconds, 0)->setPrecision(1);
+	gui->addButton("Replay");
+	gui->addButton("Add a House");
+	gui->addButton("Add Fireman");
+	gui->addButton("Statistics CSV")->setLabel("Statistics CSV: off");
+	gui->addButton("Fire perimeters")->setLabel("Fire perimeters: off");
+	gui->addButton("Export perimeters");
+    gui->addButton("Reset");
+    gui->addBreak();
+    
+
+    gui->onButtonEvent(this, &ofApp::onButtonEvent);
+    gui->onToggleEvent(this, &ofApp::onToggleEvent);
+    gui->onSliderEvent(this, &ofApp::onSliderEvent);
+	gui->onDropdownEvent(this, &ofApp::onDropdownEvent);
+    gui->setLabelAlignment(ofxDatGuiAlignment::CENTER);
+    
+    gui->setPosition(ofxDatGuiAnchor::BOTTOM_RIGHT); // This should be done at the end
+	gui->setAutoDraw(false); // troubles with multiple windows drawings on Windows
+}
+
+// Button Events - runs when a button is clicked on the interface
+void ofApp::onButtonEvent(ofxDatGuiButtonEvent e){
+	//cout << "\nInside ofApp::onButtonEvent function";
+	if (isLiveInputIgnored())
+		return;
+	if (journal.isRecording())
+		journal.writeButton(e.target->getName());
+
+	/*** 
+	START BUTTON:
+	Clears the previous fire and the markers.
+	Sets the cell at the starting point selected in the slider on fire
+	***/
+	if (e.target->is("Start")) {
+		Markers.clear();
+
+		showArrivalTime = false;
+		if (coarseElevationOutdated)
+			updateFireElevation();
+		fireEngine.clearFire();
+		sandSurfaceRenderer->clearFireStates();
+		fireEngine.ignite(fireGrid.getCellX(StartX), fireGrid.getCellY(StartY));
+		clearFireHistory();
+		recordFireSnapshot();
+	}
+
+	/***
+	RESET BUTTON:
+	Clears all vectors (the vehicle layers are erased where they were); Reset grid and check variables
+	***/
+    if (e.target->is("Reset")) {
+        
+		// Clear all vectors
+		Markers.clear();
+		Houses.clear();
+		HousesWithBarrier.clear();
+		Firemen.clear();
+
+        showMotherFire = false;
+		
+		// Reset all values in the grid to 0 (not burning)
+		fireEngine.reset();
+		sandSurfaceRenderer->clearFireStates();
+
+		fireEnsemble.cancel();
+		sandSurfaceRenderer->clearBurnProbabilities();
+		burnProbabilitiesOutdated = false;
+		showArrivalTime = false;
+		clearFireHistory();
+
+		// Reset Check Variables
+		FiremanSet = false;
+		firemanNearHouse = false;
+		burnHouse = false;
+		houseBurnTick = -1;
+    }
+
+	/***
+	'BURN PROBABILITY' BUTTON:
+	Runs the model many times from the starting point selected in the slider (in the background, on the current
+	topography, parameters and houses with barrier) and shows how often every cell caught fire
+	***/
+	if (e.target->is("Burn probability")) {
+		if (fireElevationOutdated || coarseElevationOutdated)
+			updateFireElevation();
+		sandSurfaceRenderer->clearBurnProbabilities();
+		fireEnsemble.start(fireEngine, fireGrid.getCellX(StartX), fireGrid.getCellY(StartY), ensembleRealizations, ensembleTicks, fireEngine.getSeed() + ++ensembleRuns * 2654435761u);
+		burnProbabilitiesOutdated = true;
+	}
+
+	/***
+	'ARRIVAL TIME' BUTTON:
+	Clears the fire and computes when a fire starting at the starting point reaches every cell (deterministic),
+	the fire is then shown at the time step selected with the "Time" slider
+	***/
+	if (e.target->is("Arrival time")) {
+		Markers.clear();
+		fireEngine.clearFire();
+		clearFireHistory();
+		solveArrivalTime();
+	}
+
+	/***
+	'REPLAY' BUTTON:
+	Runs the fire again from the time selected with the "Rewind (s)" slider, on the current topography.
+	The snapshots after it are replaced by the new fire.
+	***/
+	if (e.target->is("Replay")) {
+		fireRewound = false;
+		rewindSeconds = 0;
+		gui->getSlider("Rewind (s)")->setValue(0);
+		fireClock.reset();
+	}
+
+	/***
+	'LOAD FUEL MAP' BUTTON:
+	Reads the fuel model of every pixel of the kinect ROI from the colours of the image bin/data/fuelMap.png
+	(stretched over the ROI, see fuelModelColors)
+	***/
+	if (e.target->is("Load fuel map")) {
+		if (loadFuelMap(fuelMapFile) && showArrivalTime)
+			solveArrivalTime();
+	}
+
+	/***
+	'ADD A HOUSE' BUTTON:
+	Clears Houses and HousesWithBarriers vector and adds a new house at a random location
+	***/
+	if (e.target->is("Add a House")) {
+		Houses.clear();
+		HousesWithBarrier.clear();
+		showMotherFire = false;
+		addHouse();
+	}
+
+	/***
+	'ADD FIREMAN' BUTTON:
+	Clears Firemen vector and adds a new fireman at a random location
+	***/
+	if (e.target->is("Add Fireman")) {
+		Firemen.clear();
+		addFireman();
+	}
+
+	/***
+	'STATISTICS CSV' BUTTON:
+	Starts or stops appending the statistics of every time step to bin/data/fireStatistics.csv (the file is
+	created again at every start)
+	***/
+	if (e.target->is("Statistics CSV")) {
+		if (fireStatisticsLog.isOpen())
+			fireStatisticsLog.close();
+		else if (!fireStatisticsLog.open(ofToDataPath(statisticsFile)))
+			ofLogError("ofApp") << "onButtonEvent(): cannot write " << statisticsFile;
+		e.target->setLabel(fireStatisticsLog.isOpen() ? "Statistics CSV: on" : "Statistics CSV: off");
+	}
+
+	/***
+	'FIRE PERIMETERS' BUTTON:
+	Switches between the outlines of the front and of the burn scar and the color of every cell
+	***/
+	if (e.target->is("Fire perimeters")) {
+		showFirePerimeters = !showFirePerimeters;
+		e.target->setLabel(showFirePerimeters ? "Fire perimeters: on" : "Fire perimeters: off");
+	}
+
+	/***
+	'NEIGHBOURS' BUTTON:
+	Switches between the spread to the four neighbours sharing an edge with a burning cell and the spread to the
+	eight neighbours (the diagonal ones as well), which gives rounder fires with any wind angle.
+	***/
+	if (e.target->is("Neighbours")) {
+		bool moore = fireEngine.getNeighbourhood() == FireSpreadEngine::MOORE;
+		fireEngine.setNeighbourhood(moore ? FireSpreadEngine::VON_NEUMANN : FireSpreadEngine::MOORE);
+		e.target->setLabel(moore ? "Neighbours: 4" : "Neighbours: 8");
+		if (showArrivalTime)
+			solveArrivalTime();
+	}
+
+	/***
+	'EXPORT PERIMETERS' BUTTON:
+	Writes the outlines of the front and of the burn scar to bin/data/firePerimeters.geojson, in kinect pixels
+	***/
+	if (e.target->is("Export perimeters")) {
+		firePerimeter.update(fireEngine);
+		if (!firePerimeter.save(ofToDataPath(perimeterFile), fireGrid.getLeft(), fireGrid.getTop(), fireGrid.getPitch()))
+			ofLogError("ofApp") << "onButtonEvent(): cannot write " << perimeterFile;
+	}
+}
+
+// Dropdown Events - runs when an option is chosen in one of the dropdowns on the interface
+void ofApp::onDropdownEvent(ofxDatGuiDropdownEvent e) {
+	//cout << "\nInside ofApp::onDropdownEvent() function";
+	if (isLiveInputIgnored())
+		return;
+	if (journal.isRecording())
+		journal.writeDropdown(e.target->getName(), e.parent, e.child);
+	
+	/*** WIND SPEED DROPDOWN ***/
+	//No Wind
+	if (e.parent == 1 & e.child == 0) {
+		fireEngine.setWindSpeed(FireSpreadEngine::NO_WIND);
+	}
+	//Low Wind Speed
+	if (e.parent == 1 & e.child == 1) {
+		fireEngine.setWindSpeed(FireSpreadEngine::LOW_WIND);	// Velocity = 0.42 m/s
+	}
+	//High Wind Speed
+	if (e.parent == 1 & e.child == 2) {
+		fireEngine.setWindSpeed(FireSpreadEngine::HIGH_WIND);	// Velocity = 1.15 m/s
+	}
+	
+	/*** WIND DIRECTION DROPDOWN ***/
+	if (e.parent == 2 & e.child == 0) {
+		fireEngine.setWindDirection(FireSpreadEngine::WEST);		// West to East
+	}
+	if (e.parent == 2 & e.child == 1) {
+		fireEngine.setWindDirection(FireSpreadEngine::EAST);		// East to West
+	}
+	if (e.parent == 2 & e.child == 2) {
+		fireEngine.setWindDirection(FireSpreadEngine::SOUTH);	// South to North
+	}
+	if (e.parent == 2 & e.child == 3) {
+		fireEngine.setWindDirection(FireSpreadEngine::NORTH);	// North to South
+	}
+	// the wind sliders show the wind of the option
+	if (e.parent == 1 || e.parent == 2) {
+		gui->getSlider("Wind angle")->setValue(fireEngine.getWindAngle());
+		gui->getSlider("Wind speed (m/s)")->setValue(fireEngine.getWindVelocity());
+	}
+
+	/*** VEGETATION TYPE DROPDOWN ***/
+	if (e.parent == 3 & e.child == 0) {
+		fireEngine.setVegetationType(FireSpreadEngine::EVERGREEN);
+	}
+	if (e.parent == 3 & e.child == 1) {
+		fireEngine.setVegetationType(FireSpreadEngine::GRASSLAND);
+	}
+	if (e.parent == 3 & e.child == 2) {
+		fireEngine.setVegetationType(FireSpreadEngine::PINUS);
+	}
+	// the fuel map painted or loaded is replaced by the uniform vegetation
+	if (e.parent == 3) {
+		fillFuelMap(fireEngine.getVegetationType());
+	}
+
+	/*** CELL SIZE DROPDOWN ***/
+	// smaller cells give a finer fire but a longer time step, the adaptive grid only samples the topography
+	// at 1 px around the front
+	if (e.parent == 4) {
+		const int pitches[4] = { 1, 2, 4, 1 };
+		fireCellPitch = pitches[e.child];
+		adaptiveFireGrid = e.child == 3;
+		setupFireGrid();
+	}
+
+	/*** FUEL MAP DROPDOWN ***/
+	// the fuel map is shown over the main window while the fuel models of the options are painted
+	if (e.parent == 5) {
+		const int models[5] = { -1, FireSpreadEngine::EVERGREEN, FireSpreadEngine::GRASSLAND, FireSpreadEngine::PINUS, FireSpreadEngine::NON_BURNABLE };
+		paintFuelModel = models[e.child];
+	}
+
+	// the arrival times shown follow the parameters
+	if (showArrivalTime && e.parent != 4 && e.parent != 5)
+		solveArrivalTime();
+}
+
+// Slider Events - runs when a slider value changes in the interface
+void ofApp::onSliderEvent(ofxDatGuiSliderEvent e){
+	//cout << "\nInside ofApp::onSliderEvent function";
+	if (isLiveInputIgnored())
+		return;
+	if (journal.isRecording())
+		journal.writeSlider(e.target->getName(), e.value);
+
+	// Set the number of timesteps per second
+	if (e.target->is("Ticks per second")) {
+		fireClock.setTicksPerSecond(e.value);
+	}
+
+	// Time step of the arrival time shown
+	if (e.target->is("Time")) {
+		arrivalTime = e.value;
+	}
+
+	// Wind between the options of the dropdowns: direction the wind blows towards (degrees) and velocity
+	if (e.target->is("Wind angle") || e.target->is("Wind speed (m/s)")) {
+		if (e.target->is("Wind angle"))
+			fireEngine.setWind(e.value, fireEngine.getWindVelocity());
+		else
+			fireEngine.setWind(fireEngine.getWindAngle(), e.value);
+		if (showArrivalTime)
+			solveArrivalTime();
+	}
+
+	// Seconds of simulation to go back in time, 0 goes back to the latest snapshot and lets the fire run again
+	if (e.target->is("Rewind (s)")) {
+		rewindSeconds = e.value;
+		rewindFire();
+	}
+
+	// Sets the starting point of fire and adds a marker when slider value changes
+	if (e.target->is("X coordinate")) {
+		StartXSlider = e.value;
+		if (fireEngine.getNumberOfBurningCells() == 0 && !showArrivalTime)
+			addMarker(StartX, StartY);
+	}
+	if (e.target->is("Y coordinate")) {
+		StartYSlider = e.value;
+		if (fireEngine.getNumberOfBurningCells() == 0 && !showArrivalTime)
+			addMarker(StartX, StartY);
+	}
+}
+
+// Key Pressed Events - runs when a key is pressed on the keyboard
+// Control the movement of fireman using arrow keys (truck)
+void ofApp::keyPressed(int key) {
+	//cout << "\nInside ofApp::keyPressed function";
+	if (isLiveInputIgnored())
+		return;
+	if (journal.isRecording())
+		journal.writeKey(key);
+	if (FiremanSet) {
+		for (auto & fm : Firemen) {
+			if ((key == OF_KEY_UP) | (key == OF_KEY_DOWN) | (key == OF_KEY_LEFT) | (key == OF_KEY_RIGHT)) {
+				
+				// Move the fireman when an arrow key is pressed
+				fm.moveFireman(key);
+				vehicleLayers.setDirty(fm.getBounds());	// the fireman may have turned
+
+				// Check if Fireman is near house
+				// If yes, convert the house to house with barrier
+				if (!firemanNearHouse) {
+					int x;
+					int y;
+					for (auto & h : Houses) {
+						x = static_cast<int>(h.getLocation().x);
+						y = static_cast<int>(h.getLocation().y);
+						int fm_x = static_cast<int>(fm.getLocation().x);
+						int fm_y = static_cast<int>(fm.getLocation().y);
+						
+						//check if fireman is near the House
+						for (int i = -15; (i <= 15); i++) {
+							for (int j = -15; (j <= 15); j++) {
+								if ((fm_x == (x + i)) & (fm_y == (y + j)))
+									firemanNearHouse = true;
+							}
+						}
+					}
+					if (firemanNearHouse & !showhouseWithBarrier) {
+						Houses.clear();
+						HousesWithBarrier.clear();
+						showMotherFire = false;
+						addHouseWithBarrier(x, y);
+						showhouseWithBarrier = true;
+					}
+				}
+			}
+		}
+	}
+}
+
+// Allocates the fire grid covering the current kinect ROI, the current fire is lost
+void ofApp::setupFireGrid() {
+	fireGrid.setup(kinectROI.getLeft(), kinectROI.getTop(), kinectROI.getWidth(), kinectROI.getHeight(), fireCellPitch);
+	fireEngine.setup(fireGrid.getCols(), fireGrid.getRows(), fireGrid.getPitch());
+	fireElevation.resize(fireGrid.getCols() * fireGrid.getRows());
+	fireElevationOutdated = true;
+	fireAdaptiveGrid.setup(fireGrid.getCols(), fireGrid.getRows());
+	// the corners of the cells, up to the right and bottom edges of the ROI that the last cells do not reach
+	fireProjCoords.setup(fireGrid.getLeft(), fireGrid.getTop(), fireGrid.getPitch(),
+		static_cast<int>(std::ceil(kinectROI.getWidth() / fireGrid.getPitch())) + 1, static_cast<int>(std::ceil(kinectROI.getHeight() / fireGrid.getPitch())) + 1);
+	fireProjCoords.update(*kinectProjector);
+	sandSurfaceRenderer->setupFireStates(fireGrid.getCols(), fireGrid.getRows(), fireGrid.getLeft(), fireGrid.getTop(), fireGrid.getPitch());
+	updateFuelModels();
+
+	// the burn probabilities of the previous grid are lost
+	fireEnsemble.cancel();
+	sandSurfaceRenderer->clearBurnProbabilities();
+	burnProbabilitiesOutdated = false;
+	showArrivalTime = false;
+	clearFireHistory();
+
+	// the houses with barrier protect the new grid too
+	for (auto & hb : HousesWithBarrier)
+		protectFireGrid(hb.getLocation());
+}
+
+// Samples the elevation of the sand at every cell of the fire grid (the engine derives the slopes from it)
+// Cells outside the kinect ROI are treated as water so that the fire cannot reach them
+void ofApp::updateFireElevation() {
+	kinectProjector->elevationGridAtKinectCoord(fireGrid.getLeft(), fireGrid.getTop(), fireGrid.getPitch(), fireGrid.getCols(), fireGrid.getRows(), fireElevation.data(), -1);
+	fireEngine.setElevation(fireElevation.data());
+	fireElevationOutdated = false;
+	coarseElevationOutdated = false;
+}
+
+// Samples the elevation of the blocks of the adaptive grid only (the engine recomputes their slopes)
+void ofApp::updateRefinedFireElevation(const vector<int>& blocks) {
+	int cols = fireGrid.getCols();
+	for (int block : blocks) {
+		int x, y, width, height;
+		fireAdaptiveGrid.getBlockArea(block, x, y, width, height);
+		fireBlockElevation.resize(width * height);
+		kinectProjector->elevationGridAtKinectCoord(fireGrid.getKinectX(x), fireGrid.getKinectY(y), fireGrid.getPitch(), width, height, fireBlockElevation.data(), -1);
+		for (int j = 0; j < height; j++)
+			std::copy(fireBlockElevation.begin() + j * width, fireBlockElevation.begin() + (j + 1) * width, fireElevation.begin() + (y + j) * cols + x);
+		fireEngine.setElevation(fireElevation.data(), x, y, width, height);
+	}
+}
+
+// Refines the blocks of the adaptive grid around the fire, the blocks refined since the last call are sampled at once
+void ofApp::refineFireGrid() {
+	if (adaptiveFireGrid && fireAdaptiveGrid.update(fireEngine))
+		updateRefinedFireElevation(fireAdaptiveGrid.getNewlyRefinedBlocks());
+}
+
+// Colours of the fuel models in the fuel map images and over the main window, indexed by FireSpreadEngine::VegetationType
+static const ofColor fuelModelColors[FireSpreadEngine::numberOfFuelModels] = {
+	ofColor(34, 139, 34),		// Evergreen Forest
+	ofColor(220, 205, 110),		// Grasslands
+	ofColor(0, 85, 45),			// Pinus Forest
+	ofColor(128, 128, 128)		// firebreaks, roads, bare rock (non burnable)
+};
+
+// Gives the same fuel model to every pixel of the fuel map
+void ofApp::fillFuelMap(int model) {
+	std::fill(fuelMap.begin(), fuelMap.end(), static_cast<unsigned char>(model));
+	updateFuelMapImage(ofRectangle(0, 0, kinectRes.x, kinectRes.y));
+	updateFuelModels();
+}
+
+// Fuel map of the kinect ROI from an image: every pixel gets the fuel model of the closest colour
+bool ofApp::loadFuelMap(const string& path) {
+	ofImage image;
+	if (!image.load(path)) {
+		ofLogError("ofApp") << "loadFuelMap(): cannot load the fuel map " << path;
+		return false;
+	}
+	ofRectangle area = kinectROI.getIntersection(ofRectangle(0, 0, kinectRes.x, kinectRes.y));
+	image.setImageType(OF_IMAGE_COLOR);
+	image.resize(area.getWidth(), area.getHeight());
+	const ofPixels& pixels = image.getPixels();
+	int width = static_cast<int>(kinectRes.x);
+	for (int y = 0; y < image.getHeight(); y++) {
+		for (int x = 0; x < image.getWidth(); x++) {
+			ofColor color = pixels.getColor(x, y);
+			int closest = 0;
+			int closestDistance = 3 * 256 * 256;
+			for (int model = 0; model < FireSpreadEngine::numberOfFuelModels; model++) {
+				const ofColor& c = fuelModelColors[model];
+				int distance = (color.r - c.r) * (color.r - c.r) + (color.g - c.g) * (color.g - c.g) + (color.b - c.b) * (color.b - c.b);
+				if (distance < closestDistance) {
+					closest = model;
+					closestDistance = distance;
+				}
+			}
+			fuelMap[(static_cast<int>(area.getTop()) + y) * width + static_cast<int>(area.getLeft()) + x] = static_cast<unsigned char>(closest);
+		}
+	}
+	updateFuelMapImage(area);
+	updateFuelModels();
+	return true;
+}
+
+// Paints the fuel model selected in the "Fuel map" dropdown around a point of the main window
+void ofApp::paintFuelMap(int x, int y) {
+	if (paintFuelModel < 0 || !mainView.inside(x, y))
+		return;
+	int kinectX = static_cast<int>((x - mainView.x) * kinectRes.x / mainView.width);
+	int kinectY = static_cast<int>((y - mainView.y) * kinectRes.y / mainView.height);
+	ofRectangle brush(kinectX - fuelBrushRadius, kinectY - fuelBrushRadius, 2 * fuelBrushRadius + 1, 2 * fuelBrushRadius + 1);
+	brush = brush.getIntersection(kinectROI.getIntersection(ofRectangle(0, 0, kinectRes.x, kinectRes.y)));
+	if (brush.isEmpty())
+		return;
+
+	int width = static_cast<int>(kinectRes.x);
+	for (int py = static_cast<int>(brush.getTop()); py < static_cast<int>(brush.getBottom()); py++) {
+		for (int px = static_cast<int>(brush.getLeft()); px < static_cast<int>(brush.getRight()); px++) {
+			if ((px - kinectX) * (px - kinectX) + (py - kinectY) * (py - kinectY) <= fuelBrushRadius * fuelBrushRadius)
+				fuelMap[py * width + px] = static_cast<unsigned char>(paintFuelModel);
+		}
+	}
+	updateFuelMapImage(brush);
+	updateFuelModels();
+}
+
+// Samples the fuel map on the fire grid, at the kinect pixels of the cells
+void ofApp::updateFuelModels() {
+	if (fuelMap.empty())
+		return;
+	int width = static_cast<int>(kinectRes.x);
+	int height = static_cast<int>(kinectRes.y);
+	fireFuelModels.resize(fireGrid.getCols() * fireGrid.getRows());
+	for (int y = 0; y < fireGrid.getRows(); y++) {
+		int kinectY = ofClamp(fireGrid.getKinectY(y), 0, height - 1);
+		for (int x = 0; x < fireGrid.getCols(); x++) {
+			int kinectX = ofClamp(fireGrid.getKinectX(x), 0, width - 1);
+			fireFuelModels[y * fireGrid.getCols() + x] = fuelMap[kinectY * width + kinectX];
+		}
+	}
+	fireEngine.setFuelModels(fireFuelModels.data());
+}
+
+// Colours of an area of the fuel map (kinect pixels) in fuelMapImage
+void ofApp::updateFuelMapImage(const ofRectangle& area) {
+	ofPixels& pixels = fuelMapImage.getPixels();
+	int width = static_cast<int>(kinectRes.x);
+	for (int y = static_cast<int>(area.getTop()); y < static_cast<int>(area.getBottom()); y++) {
+		for (int x = static_cast<int>(area.getLeft()); x < static_cast<int>(area.getRight()); x++)
+			pixels.setColor(x, y, ofColor(fuelModelColors[fuelMap[y * width + x]], 128));
+	}
+	fuelMapImage.update();
+}
+
+// State of a cell of the fire grid: the arrival time at the time shown or the fire spread model
+int ofApp::getFireCellState(int x, int y) {
+	if (showArrivalTime)
+		return fireEngine.isInside(x, y) ? fireArrival.getCellState(y * fireGrid.getCols() + x, arrivalTime) : FireSpreadEngine::UNBURNT;
+	return fireEngine.getCellState(x, y);
+}
+
+// Arrival time of a fire starting at the starting point, on the current topography, parameters and houses with barrier
+void ofApp::solveArrivalTime() {
+	if (fireElevationOutdated || coarseElevationOutdated)
+		updateFireElevation();
+	showArrivalTime = fireArrival.solve(fireEngine, fireGrid.getCellX(StartX), fireGrid.getCellY(StartY));
+
+	// everything is drawn again at the next update
+	sandSurfaceRenderer->clearFireStates();
+	drawnArrivalTime = -1;
+}
+
+// Draws the fire at the time shown: only the cells that caught fire or burnt out between the time drawn and the time
+// shown (in either direction) are copied to the fire state texture of the sandbox
+void ofApp::drawArrivalTime() {
+	if (arrivalTime == drawnArrivalTime)
+		return;
+
+	arrivalChangedCells.clear();
+	fireArrival.getChangedCells(drawnArrivalTime, arrivalTime, arrivalChangedCells);
+	for (int index : arrivalChangedCells)
+		sandSurfaceRenderer->setFireCellState(fireEngine.getCellX(index), fireEngine.getCellY(index), fireArrival.getCellState(index, arrivalTime));
+	drawnArrivalTime = arrivalTime;
+}
+
+// Forgets the snapshots of the previous fire
+void ofApp::clearFireHistory() {
+	fireHistory.clear();
+	sceneHistory.clear();
+	fireRewound = false;
+	rewindSeconds = 0;
+	gui->getSlider("Rewind (s)")->setValue(0);
+}
+
+// Snapshot of the fire, houses and firemen after the time steps of this frame
+void ofApp::recordFireSnapshot() {
+	// fireHistory drops the snapshots after the current one (the fire that was rewound) and the oldest one when it is full
+	sceneHistory.resize(fireHistory.getCurrentSnapshot() + 1);
+	fireHistory.record(fireEngine);
+
+	SceneSnapshot scene;
+	for (auto & h : Houses) {
+		scene.houses.push_back(h.getLocation());
+		scene.burningHouses.push_back(h.burningState);
+	}
+	for (auto & hb : HousesWithBarrier)
+		scene.housesWithBarrier.push_back(hb.getLocation());
+	for (auto & fm : Firemen)
+		scene.firemen.push_back(fm.getLocation());
+	scene.burnHouse = burnHouse;
+	scene.houseBurnTick = houseBurnTick;
+	scene.FiremanSet = FiremanSet;
+	scene.firemanNearHouse = firemanNearHouse;
+	scene.showhouseWithBarrier = showhouseWithBarrier;
+	sceneHistory.push_back(scene);
+	while (static_cast<int>(sceneHistory.size()) > fireHistory.getNumberOfSnapshots())
+		sceneHistory.pop_front();
+}
+
+// Restores the snapshot rewindSeconds seconds of simulation (at the current speed) before the latest one
+void ofApp::rewindFire() {
+	int snapshots = fireHistory.getNumberOfSnapshots();
+	if (snapshots == 0 || showArrivalTime)
+		return;
+	unsigned int latestTick = fireHistory.getTick(snapshots - 1);
+	double ticksBack = rewindSeconds * fireClock.getTicksPerSecond();
+	unsigned int tick = ticksBack < latestTick ? latestTick - static_cast<unsigned int>(ticksBack) : 0;
+	int snapshot = max(fireHistory.findSnapshot(tick), 0);
+
+	int previous = fireHistory.getCurrentSnapshot();
+	if (snapshot != previous && fireHistory.restore(snapshot, fireEngine)) {
+		// the cells that changed in either direction are drawn by drawVehicles()
+		restoreScene(sceneHistory[snapshot]);
+	}
+	fireRewound = rewindSeconds > 0;
+	fireClock.reset();
+}
+
+// Houses, houses with barrier and firemen of a snapshot, the objects are only created again when they changed
+void ofApp::restoreScene(const SceneSnapshot& scene) {
+	bool housesChanged = scene.houses.size() != Houses.size() || scene.housesWithBarrier.size() != HousesWithBarrier.size();
+	for (size_t i = 0; i < Houses.size() && !housesChanged; i++)
+		housesChanged = Houses[i].getLocation() != scene.houses[i];
+	for (size_t i = 0; i < HousesWithBarrier.size() && !housesChanged; i++)
+		housesChanged = HousesWithBarrier[i].getLocation() != scene.housesWithBarrier[i];
+	if (housesChanged) {
+		Houses.clear();
+		for (auto & location : scene.houses) {
+			auto h = House(kinectProjector, location, kinectROI, motherFire);
+			h.setup();
+			Houses.push_back(h);
+		}
+		HousesWithBarrier.clear();
+		for (auto & location : scene.housesWithBarrier) {
+			auto hb = houseWithBarrier(kinectProjector, location, kinectROI, motherFire);
+			hb.setup();
+			HousesWithBarrier.push_back(hb);
+		}
+	}
+	for (size_t i = 0; i < Houses.size(); i++) {
+		if (Houses[i].burningState != scene.burningHouses[i]) {
+			Houses[i].burningState = scene.burningHouses[i];
+			Houses[i].sprite = Houses[i].burningState ? SpriteAtlas::BURNING_HOUSE : SpriteAtlas::HOUSE;
+			vehicleLayers.setDirty(Houses[i].getBounds());
+		}
+	}
+
+	if (scene.firemen.size() != Firemen.size()) {
+		Firemen.clear();
+		for (auto & location : scene.firemen) {
+			auto fm = Fireman(kinectProjector, location, kinectROI, motherFire);
+			fm.setup();
+			Firemen.push_back(fm);
+		}
+	}
+	for (size_t i = 0; i < Firemen.size(); i++)
+		Firemen[i].setLocation(scene.firemen[i]);
+
+	burnHouse = scene.burnHouse;
+	houseBurnTick = scene.houseBurnTick;
+	FiremanSet = scene.FiremanSet;
+	firemanNearHouse = scene.firemanNearHouse;
+	showhouseWithBarrier = scene.showhouseWithBarrier;
+}
+
+// Session journal to record or replay, opened in setup()
+void ofApp::setJournal(SessionJournal::Mode mode, const string& path) {
+	journalMode = mode;
+	journalPath = path;
+}
+
+// Feeds the input events of the current frame of the replayed session to the same functions as the GUI and keyboard
+void ofApp::replayInputEvents() {
+	replayingInput = true;
+	SessionJournal::InputEvent event;
+	while (journal.readInputEvent(event)) {
+		if (event.type == SessionJournal::BUTTON_RECORD)
+			onButtonEvent(ofxDatGuiButtonEvent(gui->getButton(event.name)));
+		else if (event.type == SessionJournal::DROPDOWN_RECORD)
+			onDropdownEvent(ofxDatGuiDropdownEvent(gui->getDropdown(event.name), event.parent, event.child));
+		else if (event.type == SessionJournal::SLIDER_RECORD)
+			onSliderEvent(ofxDatGuiSliderEvent(gui->getSlider(event.name), event.value, 0));	// the scale is not used
+		else if (event.type == SessionJournal::KEY_RECORD)
+			keyPressed(event.key);
+		else if (event.type == SessionJournal::MOUSE_PRESSED_RECORD)
+			mousePressed(event.x, event.y, event.button);
+		else if (event.type == SessionJournal::MOUSE_DRAGGED_RECORD)
+			mouseDragged(event.x, event.y, event.button);
+	}
+	replayingInput = false;
+}
+
+// Marker for showing the staring location on the display
+void ofApp::addMarker(int x, int y) {
+	//cout << "\nInside ofApp::addMarker function";
+
+	if (setMarkerLocation(kinectROI, false)) {
+		addNewMarker(StartXSlider, StartYSlider);
+	}
+}
+
+// Set the location of the marker and checks if marker is on water
+bool ofApp::setMarkerLocation(ofRectangle area, bool liveInWater) {
+	//cout << "\nInside ofApp::setMarkerLocation function";
+
+	float x = StartXSlider;
+	float y = StartYSlider;
+	bool insideWater = kinectProjector->elevationAtKinectCoord(x, y) < 0;
+	if ((insideWater && liveInWater) || (!insideWater && !liveInWater)) {
+		StartX = x;
+		StartY = y;
+	}
+	else {
+		cout << "\nCannot start fire on water!!";
+		StartX = kinectROI.getLeft();
+		StartY = kinectROI.getTop();
+	}
+	return true;
+}
+
+// add a new marker
+void ofApp::addNewMarker(float x, float y) {
+	//cout << "\nInside ofApp::addNewMarker function";
+	Markers.clear();
+	ofVec2f location = ofVec2f(x, y);
+	cout << "\n" << (kinectProjector->elevationAtKinectCoord(x, y));
+	auto m = Marker(kinectProjector, location, kinectROI, motherFire);
+	m.setup();
+	Markers.push_back(m);
+}
+
+// Adds a house at a random position on land
+void ofApp::addHouse() {
+	//cout << "\nInside ofApp::addHouse function";
+	float gridForHouse[31][31][2] = {0};
+	ofVec2f location;
+	bool HouseSet = false;
+	while (!HouseSet) {
+		float x = ofRandom((kinectROI.getLeft() + 10), (kinectROI.getRight() - 10)); // +/-10 so that the house is not put on the borders
+		float y = ofRandom((kinectROI.getTop() + 10), (kinectROI.getBottom() - 10));
+		bool HouseInWater = false;
+		//to create grid of locations surrounding the house
+		for (int i = -15; (i <= 15) & (!HouseInWater); i++) {
+			for (int j = -15; (j <= 15) & (!HouseInWater); j++) {
+					gridForHouse[i+15][j+15][0] = x + i;
+					gridForHouse[i+15][j+15][1] = y + j;
+					if (kinectProjector->elevationAtKinectCoord(gridForHouse[i+15][j+15][0], gridForHouse[i+15][j+15][1]) < 0)
+						HouseInWater = true;
+			}
+		}
+		if (!HouseInWater ) {
+			location = ofVec2f(x, y);
+			HouseSet = true;
+		}
+	}
+	auto h = House(kinectProjector, location, kinectROI, motherFire);
+	h.setup();
+	Houses.push_back(h);
+	burnHouse = false;
+	houseBurnTick = -1;
+}
+
+// Adds a house with barrier at the location of the house (thus converting house to house with barrier)
+bool ofApp::addHouseWithBarrier(float h_x, float h_y) {
+	//cout << "\nInside addHouseWithBarrier() function";
+
+	ofVec2f location = ofVec2f(h_x, h_y);
+	
+	auto h = houseWithBarrier(kinectProjector, location, kinectROI, motherFire);
+	h.setup();
+	HousesWithBarrier.push_back(h);
+
+	protectFireGrid(h.getLocation());
+	return true;
+}
+
+// Protects the cells of the fire grid around a house with barrier
+void ofApp::protectFireGrid(const ofPoint& location) {
+	int house_x = fireGrid.getCellX(location.x);
+	int house_y = fireGrid.getCellY(location.y);
+	int radius = houseBarrierRadius / fireGrid.getPitch();
+	for (int i = -radius; i <= radius; i++) {
+		for (int j = -radius; j <= radius; j++) {
+			fireEngine.protect(i + house_x, j + house_y);
+		}
+	}
+}
+
+// Adds a fireman at a random location on an unburnt/extinguished cell on land
+void ofApp::addFireman() {
+	//cout << "\nInside ofApp::addFireman function";
+	FiremanSet = false;
+	
+	// set a random location for fireman
+	ofVec2f location;
+	while (!FiremanSet) {
+		float x = ofRandom((kinectROI.getLeft() + 10), (kinectROI.getRight() - 10)); // +/-10 so that the Fireman is not put on the borders
+		float y = ofRandom((kinectROI.getTop() + 10), (kinectROI.getBottom() - 10));
+		int temp_x = fireGrid.getCellX(x);
+		int temp_y = fireGrid.getCellY(y);
+
+		bool FiremanInWater = false;
+		bool FiremanOnFire = false;
+		if (kinectProjector->elevationAtKinectCoord(x, y) < 0)
+			FiremanInWater = true;
+		if (fireEngine.getCellState(temp_x, temp_y) == FireSpreadEngine::BURNING)
+			FiremanOnFire = true;
+		if (!FiremanInWater & !FiremanOnFire) {
+			location = ofVec2f(x, y);
+			FiremanSet = true;
+		}
+	}
+	auto fm = Fireman(kinectProjector, location, kinectROI, motherFire);
+	fm.setup();
+	Firemen.push_back(fm);
+}
+
+void ofApp::onToggleEvent(ofxDatGuiToggleEvent e) {
+}
+
+void ofApp::keyReleased(int key) {
+	//cout << "\nInside ofApp::keyReleased function";
+}
+
+void ofApp::mouseMoved(int x, int y) {
+	//cout << "\nInside ofApp::mouseMoved function";
+}
+
+void ofApp::mouseDragged(int x, int y, int button) {
+	//cout << "\nInside ofApp::mouseDragged function";
+	if (isLiveInputIgnored())
+		return;
+	if (paintFuelModel >= 0) {
+		if (journal.isRecording())
+			journal.writeMouseDragged(x, y, button);
+		paintFuelMap(x, y);
+	}
+}
+
+void ofApp::mousePressed(int x, int y, int button) {
+	//cout << "\nInside ofApp::mousePressed function";
+	if (isLiveInputIgnored())
+		return;
+	if (paintFuelModel >= 0) {
+		if (journal.isRecording())
+			journal.writeMousePressed(x, y, button);
+		paintFuelMap(x, y);
+	}
+}
+
+void ofApp::mouseReleased(int x, int y, int button) {
+	//cout << "\nInside ofApp::mouseReleased function";
+}
+
+void ofApp::mouseEntered(int x, int y) {
+	//cout << "\nInside ofApp::mouseEntered function";
+}
+
+void ofApp::mouseExited(int x, int y) {
+	//cout << "\nInside ofApp::mouseExited function";
+}
+
+void ofApp::windowResized(int w, int h) {
+	//cout << "\nInside ofApp::windowResized function";
+}
+
+void ofApp::gotMessage(ofMessage msg) {
+	//cout << "\nInside ofApp::gotMessage function";
+}
+
+void ofApp::dragEvent(ofDragInfo dragInfo) {
+	//cout << "\nInside ofApp::dragEvent function";
 }
\ No newline at end of file
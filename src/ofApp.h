@@ -1,138 +1,258 @@
-/***********************************************************************
-ofApp.h - main openframeworks app
-
-Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
-Univeristy of Muenster, Germany
-
-Based on Magic Sand by Thomas Wolf (2016)
-
-This file is part of the project "Fire in the Sandbox".
-Guided by Junior Prof. Dr. Judith Verstegen
-
-The "Fire in the Sandbox" is free software; you can redistribute it
-and/or modify it under the terms of the GNU General Public License as
-published by the Free Software Foundation.
-
-The "Fire in the Sandbox" is distributed in the hope that it will be
-useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-General Public License for more details.
-
-***********************************************************************/
-
-#pragma once
-
-#include "ofMain.h"
-#include "ofxDatGui.h"
-#include "KinectProjector/KinectProjector.h"
-#include "SandSurfaceRenderer/SandSurfaceRenderer.h"
-#include "vehicle.h"
-
-class ofApp : public ofBaseApp {
-
-private:
-	std::shared_ptr<KinectProjector> kinectProjector;
-	SandSurfaceRenderer* sandSurfaceRenderer;
-	
-	// Projector and kinect variables
-	ofVec2f projRes;
-	ofVec2f kinectRes;
-	ofRectangle kinectROI;
-	
-	// FBos
-	ofFbo fboVehicles;
-	ofFbo fboFireman;
-	ofFbo fboHouse;
-
-	//Vectors
-	vector<Fire> Fires;
-	vector<Fire> FiresToBeDrawn;
-	vector<Fire> FiresThatCanSpawn;
-	vector<Marker> Markers;
-	vector<House> Houses;
-	vector<houseWithBarrier> HousesWithBarrier;
-	vector<Fireman> Firemen;
-	
-	ofPoint motherFire;
-	bool showMotherFire;
-
-	// Check variables
-	bool showhouseWithBarrier;
-	bool FiremanSet;
-	bool firemanNearHouse;
-	bool burnHouse;
-
-	// Starting point of Fire
-	int StartX;
-	int StartY;
-
-	// Starting point set on Slider
-	int StartXSlider;
-	int StartYSlider;
-	
-	// GUI
-	ofxDatGui* gui;
-
-	/***
-	2D grid to store cell states
-	0 - unburnt
-	1 - burning
-	2 - extinguished
-	(3 - House With Barrier)
-	Grid size based on the kinect ROI
-	***/
-	int grid[261][157];
-
-public:
-	// Model parameters
-	string windSpeed;
-	string windDirection;
-	string vegType;
-
-	void setup();
-
-	void addNewFire(float x, float y);
-	void addNewMarker(float x, float y);
-
-	void addHouse();
-	bool addHouseWithBarrier(float h_x, float h_y);
-	void addFireman();
-
-	void update();
-
-	void draw();
-	void drawProjWindow(ofEventArgs& args);
-	void drawVehicles();
-
-	void keyPressed(int key);
-	void keyReleased(int key);
-	void mouseMoved(int x, int y);
-	void mouseDragged(int x, int y, int button);
-	void mousePressed(int x, int y, int button);
-	void mouseReleased(int x, int y, int button);
-	void mouseEntered(int x, int y);
-	void mouseExited(int x, int y);
-	void windowResized(int w, int h);
-	void dragEvent(ofDragInfo dragInfo);
-	void gotMessage(ofMessage msg);
-
-	void setupGui();
-	void onButtonEvent(ofxDatGuiButtonEvent e);
-	void onToggleEvent(ofxDatGuiToggleEvent e);
-	void onSliderEvent(ofxDatGuiSliderEvent e);
-	void onDropdownEvent(ofxDatGuiDropdownEvent e);
-
-	void addMarker(int x, int y);
-	bool setMarkerLocation(ofRectangle area, bool liveInWater);
-
-	std::shared_ptr<ofAppBaseWindow> projWindow;
-	void spreadFire();
-	float windAndSlopeEffects(float new_x, float new_y, float current_x, float current_y, float slope);
-	bool headingDirection(float new_x, float new_y, float current_x, float current_y);
-	bool backingDirection(float new_x, float new_y, float current_x, float current_y);
-	bool checkSameDirection(float new_x, float new_y, float current_x, float current_y);
-
-	float vegetationEffect(float probFromSlopeWind);
-	
-	bool Effects(float new_x, float new_y, float current_x, float current_y, float slope);
-};
+/***********************************************************************
+ofApp.h - main openframeworks app
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+Based on Magic Sand by Thomas Wolf (2016)
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxDatGui.h"
+#include "KinectProjector/KinectProjector.h"
+#include "KinectProjector/ProjCoordTable.h"
+#include "SandSurfaceRenderer/SandSurfaceRenderer.h"
+#include "FireSpreadEngine/FireSpreadEngine.h"
+#include "FireSpreadEngine/FireGridLayout.h"
+#include "FireSpreadEngine/FireClock.h"
+#include "FireSpreadEngine/FireEnsemble.h"
+#include "FireSpreadEngine/FireArrivalTime.h"
+#include "FireSpreadEngine/FireHistory.h"
+#include "FireSpreadEngine/FireStatisticsLog.h"
+#include "FireSpreadEngine/FirePerimeter.h"
+#include "FireSpreadEngine/FireAdaptiveGrid.h"
+#include "SessionJournal/SessionJournal.h"
+#include "LayerCompositor/LayerCompositor.h"
+#include "vehicle.h"
+
+class ofApp : public ofBaseApp {
+
+private:
+	std::shared_ptr<KinectProjector> kinectProjector;
+	SandSurfaceRenderer* sandSurfaceRenderer;
+	
+	// Projector and kinect variables
+	ofVec2f projRes;
+	ofVec2f kinectRes;
+	ofRectangle kinectROI;
+	
+	// Perimeters, markers, houses and firemen composited in one target at the projector resolution, drawn again
+	// only where an object changed
+	LayerCompositor vehicleLayers;
+	vector<ofRectangle> layerBounds;
+
+	//Vectors
+	vector<Marker> Markers;
+	vector<House> Houses;
+	vector<houseWithBarrier> HousesWithBarrier;
+	vector<Fireman> Firemen;
+	
+	ofPoint motherFire;
+	bool showMotherFire;
+
+	// Check variables
+	bool showhouseWithBarrier;
+	bool FiremanSet;
+	bool firemanNearHouse;
+	bool burnHouse;
+
+	// Starting point of Fire
+	int StartX;
+	int StartY;
+
+	// Starting point set on Slider
+	int StartXSlider;
+	int StartYSlider;
+	
+	// GUI
+	ofxDatGui* gui;
+
+	/***
+	Fire spread model
+	The engine keeps the 2D grid of cell states (unburnt, burning, extinguished, House With Barrier)
+	The grid covers the kinect ROI with one cell every fireCellPitch kinect pixels (1, 2 or 4, "Cell size" dropdown),
+	it is allocated again when the ROI or the pitch changes
+	***/
+	FireSpreadEngine fireEngine;
+	FireGridLayout fireGrid;
+	ProjCoordTable fireProjCoords;	// projector coordinates of the corners of the cells over the whole ROI, refreshed where the sand moved
+	FireClock fireClock;		// time steps of the model per frame ("Ticks per second" slider)
+	int fireCellPitch;
+	static const int houseBarrierRadius = 30;	// kinect pixels protected on each side of a house with barrier
+	vector<float> fireElevation;
+	bool fireElevationOutdated; // the topography has changed since the last elevation raster (new depth frame)
+
+	/***
+	Adaptive grid ("Adaptive 1 px cells" in the "Cell size" dropdown): 1 px cells, but the elevation of a new depth
+	frame is only sampled in the blocks of cells refined around the front (fireAdaptiveGrid), the coarse blocks keep
+	the previous one until the fire comes close. The whole grid is sampled again when a fire is started and before
+	the burn probability and the arrival time, which run over every cell.
+	***/
+	bool adaptiveFireGrid;
+	FireAdaptiveGrid fireAdaptiveGrid;
+	bool coarseElevationOutdated;	// the coarse blocks were not sampled with the last depth frame
+	vector<float> fireBlockElevation;
+
+	/***
+	Fuel map: fuel model (FireSpreadEngine::VegetationType) of every kinect pixel, sampled on the fire grid when it
+	changes and when the grid is allocated again. The "Vegetation type" dropdown gives the same fuel to every pixel,
+	"Load fuel map" reads the colours of fuelMapFile over the kinect ROI and the "Fuel map" dropdown paints it with
+	the mouse on the main window.
+	***/
+	vector<unsigned char> fuelMap;
+	vector<unsigned char> fireFuelModels;	// fuel map sampled on the fire grid
+	ofImage fuelMapImage;		// fuel map drawn over the main window while painting
+	int paintFuelModel;			// fuel model painted with the mouse, -1 when the fuel map is hidden
+	static const int fuelBrushRadius = 8;	// kinect pixels
+	const string fuelMapFile = "fuelMap.png";
+	const ofRectangle mainView = ofRectangle(300, 30, 600, 450);	// sandbox on the main window
+
+	/***
+	Burn probability: ensemble of runs of the fire spread model from the starting point, in the background
+	The probability of every cell to catch fire is drawn over the sandbox by sandSurfaceRenderer
+	***/
+	FireEnsemble fireEnsemble;
+	static const int ensembleRealizations = 200;
+	static const int ensembleTicks = 1000;		// time steps of a run at most
+	bool burnProbabilitiesOutdated; // the ensemble is running, its results are not drawn yet
+	unsigned int ensembleRuns;		// ensembles started, the seed of an ensemble is derived from the seed of the fire
+
+	/***
+	Arrival time: deterministic fire from the starting point, solved once and scrubbed with the "Time" slider
+	The fire spread model does not run while the arrival time is shown
+	***/
+	FireArrivalTime fireArrival;
+	bool showArrivalTime;
+	float arrivalTime;			// time step shown
+	float drawnArrivalTime;		// time step copied to the fire state texture
+	vector<int> arrivalChangedCells;
+
+	/***
+	Rewind: snapshots of the fire recorded at every frame in which the model ran (a minute at 60 frames per second),
+	the "Rewind (s)" slider goes back in time and "Replay" runs the fire again from there on the current topography
+	The houses and firemen are recorded in sceneHistory, one entry per snapshot of fireHistory
+	***/
+	struct SceneSnapshot {
+		vector<ofPoint> houses;
+		vector<bool> burningHouses;
+		vector<ofPoint> housesWithBarrier;
+		vector<ofPoint> firemen;
+		bool burnHouse;
+		int houseBurnTick;
+		bool FiremanSet;
+		bool firemanNearHouse;
+		bool showhouseWithBarrier;
+	};
+	FireHistory fireHistory;
+	deque<SceneSnapshot> sceneHistory;
+	static const int historySeconds = 60;
+	bool fireRewound;			// a snapshot is shown, the model does not run until "Replay" or the slider is back at 0
+	float rewindSeconds;
+
+	/***
+	Statistics of the fire, drawn below the sandbox next to the GUI (burnt area, front length, rate of spread and
+	time for the fire to reach the house) and appended to statisticsFile at every time step while the
+	"Statistics CSV" button is on. The engine keeps them up to date, they cost nothing per frame.
+	***/
+	FireStatisticsLog fireStatisticsLog;
+	const string statisticsFile = "fireStatistics.csv";
+	int houseBurnTick;			// time step of the fire when the house caught fire, -1 before
+
+	/***
+	Fire perimeters: outlines of the active front and of the burn scar traced from the cell states, drawn as a few
+	polylines instead of the color of every cell while the "Fire perimeters" button is on. "Export perimeters" writes
+	them to perimeterFile in kinect pixels.
+	***/
+	FirePerimeter firePerimeter;
+	bool showFirePerimeters;
+	vector<ofVec2f> perimeterProjCoords;
+	vector<ofPolyline> perimeterPolylines[FirePerimeter::numberOfLayers];
+	const string perimeterFile = "firePerimeters.geojson";
+
+	/***
+	Session journal: the seed of ofRandom and of the fire, the frame times, the depth frames and the GUI and key events are
+	recorded ("--record file") or replayed at full speed through the same functions ("--replay file")
+	***/
+	SessionJournal journal;
+	SessionJournal::Mode journalMode = SessionJournal::OFF;
+	bool replayingInput = false;	// the events come from the journal, the live inputs are ignored during a replay
+	string journalPath;
+
+public:
+	void setup();
+
+	void addNewMarker(float x, float y);
+
+	void addHouse();
+	bool addHouseWithBarrier(float h_x, float h_y);
+	void addFireman();
+
+	void update();
+
+	void draw();
+	void drawProjWindow(ofEventArgs& args);
+	void drawVehicles();
+	void drawStatistics();
+	bool updateFirePerimeters();
+	void drawFirePerimeters();
+
+	void keyPressed(int key);
+	void keyReleased(int key);
+	void mouseMoved(int x, int y);
+	void mouseDragged(int x, int y, int button);
+	void mousePressed(int x, int y, int button);
+	void mouseReleased(int x, int y, int button);
+	void mouseEntered(int x, int y);
+	void mouseExited(int x, int y);
+	void windowResized(int w, int h);
+	void dragEvent(ofDragInfo dragInfo);
+	void gotMessage(ofMessage msg);
+
+	void setupGui();
+	void onButtonEvent(ofxDatGuiButtonEvent e);
+	void onToggleEvent(ofxDatGuiToggleEvent e);
+	void onSliderEvent(ofxDatGuiSliderEvent e);
+	void onDropdownEvent(ofxDatGuiDropdownEvent e);
+
+	void addMarker(int x, int y);
+	bool setMarkerLocation(ofRectangle area, bool liveInWater);
+
+	std::shared_ptr<ofAppBaseWindow> projWindow;
+	void setupFireGrid();
+	void protectFireGrid(const ofPoint& location);
+	void updateFireElevation();
+	void updateRefinedFireElevation(const vector<int>& blocks);
+	void refineFireGrid();
+	void fillFuelMap(int model);
+	bool loadFuelMap(const string& path);
+	void paintFuelMap(int x, int y);
+	void updateFuelModels();
+	void updateFuelMapImage(const ofRectangle& area);
+	int getFireCellState(int x, int y);
+	void solveArrivalTime();
+	void drawArrivalTime();
+	void clearFireHistory();
+	void recordFireSnapshot();
+	void rewindFire();
+	void restoreScene(const SceneSnapshot& scene);
+	void setJournal(SessionJournal::Mode mode, const string& path);
+	void replayInputEvents();
+	bool isLiveInputIgnored() const {
+		return journal.isReplaying() && !replayingInput;
+	}
+};
@@ -1,108 +1,135 @@
-/***********************************************************************
-vehicle.h - vehicle class
-
-Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
-Univeristy of Muenster, Germany
-
-Based on Magic Sand by Thomas Wolf (2016)
-
-This file is part of the project "Fire in the Sandbox".
-Guided by Junior Prof. Dr. Judith Verstegen
-
-The "Fire in the Sandbox" is free software; you can redistribute it
-and/or modify it under the terms of the GNU General Public License as
-published by the Free Software Foundation.
-
-The "Fire in the Sandbox" is distributed in the hope that it will be
-useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-General Public License for more details.
-
-***********************************************************************/
-
-#pragma once
-#include "ofMain.h"
-#include "ofxOpenCv.h"
-#include "ofxCv.h"
-
-#include "KinectProjector/KinectProjector.h"
-
-//Parent class for all the objects used in the application
-class Vehicle{
-
-public:
-    Vehicle(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, bool sliveInWater, ofVec2f motherLocation);
-    
-    // Virtual functions
-    virtual void setup() = 0;
-    virtual void draw() = 0;
-    
-    void update();
-    
-    const ofPoint& getLocation() const {
-        return location;
-    }
-    
-protected:    
-    std::shared_ptr<KinectProjector> kinectProjector;
-
-    ofPoint location; //location of the vehicle
-    float angle; // direction of the drawing
- 
-    bool mother;
-    ofVec2f motherLocation;
-    
-    bool liveInWater; // false for Fires which must stay on the ground
-    
-    ofVec2f projectorCoord;
-    ofRectangle borders, internalBorders;
-    int r, minborderDist;
-};
-
-class Fire : public Vehicle {
-public:
-    Fire(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation){}
-    
-    void setup();
-    void draw();
-	int fuel;
-	int numberOfBurningNeighbours;	
-};
-
-class Marker : public Vehicle {
-public:
-	Marker(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
-
-	void setup();
-	void draw();
-};
-
-class House : public Vehicle {
-public:
-	House(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
-
-	void setup();
-	void draw();
-	ofImage image;
-	bool burningState;
-};
-
-class houseWithBarrier : public Vehicle {
-public:
-	houseWithBarrier(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
-
-	void setup();
-	void draw();
-	ofImage image;
-};
-
-class Fireman : public Vehicle {
-public:
-	Fireman(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
-
-	void setup();
-	void draw();
-	void moveFireman(int moveDirection);
-	ofImage image;
-	string lookDirection;
+/***********************************************************************
+vehicle.h - vehicle class
+
+Copyright (c) 2017 Charu Manivannan, Mina Karamesouti, Sangeetha Shankar, Zhihao Liu
+Univeristy of Muenster, Germany
+
+Based on Magic Sand by Thomas Wolf (2016)
+
+This file is part of the project "Fire in the Sandbox".
+Guided by Junior Prof. Dr. Judith Verstegen
+
+The "Fire in the Sandbox" is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation.
+
+The "Fire in the Sandbox" is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+***********************************************************************/
+
+#pragma once
+#include "ofMain.h"
+#include "ofxOpenCv.h"
+#include "ofxCv.h"
+
+#include "KinectProjector/KinectProjector.h"
+#include "KinectProjector/ProjCoordTable.h"
+
+// Images of the houses and firemen, loaded once from bin/data and packed side by side in one texture shared by
+// every vehicle: a vehicle only keeps the sprite it shows and drawing it is a subsection of the atlas
+class SpriteAtlas {
+public:
+	enum Sprite {
+		HOUSE = 0,
+		BURNING_HOUSE = 1,
+		HOUSE_WITH_BARRIER = 2,
+		FIREMAN_LEFT = 3,
+		FIREMAN_RIGHT = 4
+	};
+	static const int numberOfSprites = 5;
+
+	static SpriteAtlas& getInstance();
+
+	// Draws a sprite in the rectangle (x, y, width, height), the atlas is loaded at the first call
+	void draw(Sprite sprite, float x, float y, float width, float height);
+
+private:
+	SpriteAtlas();
+	void load();
+
+	ofTexture texture;
+	ofRectangle areas[numberOfSprites];	// pixels of every sprite in the texture
+	bool loaded;
+};
+
+//Parent class for all the objects used in the application
+class Vehicle{
+
+public:
+    Vehicle(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, bool sliveInWater, ofVec2f motherLocation);
+    
+    // Virtual functions
+    virtual void setup() = 0;
+    virtual void draw() = 0;
+    // Projector pixels covered by draw()
+    virtual ofRectangle getBounds() const = 0;
+    
+    // Projector coordinate of the location, read from the table of the fire grid
+    void update(const ProjCoordTable& projCoords);
+    
+    const ofPoint& getLocation() const {
+        return location;
+    }
+    void setLocation(const ofPoint& slocation) {
+        location = slocation;
+    }
+    
+protected:    
+    std::shared_ptr<KinectProjector> kinectProjector;
+
+    ofPoint location; //location of the vehicle
+    float angle; // direction of the drawing
+ 
+    bool mother;
+    ofVec2f motherLocation;
+    
+    bool liveInWater; // false for Fires which must stay on the ground
+    
+    ofVec2f projectorCoord;
+    ofRectangle borders, internalBorders;
+    int r, minborderDist;
+};
+
+class Marker : public Vehicle {
+public:
+	Marker(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
+
+	void setup();
+	void draw();
+	ofRectangle getBounds() const;
+};
+
+class House : public Vehicle {
+public:
+	House(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
+
+	void setup();
+	void draw();
+	ofRectangle getBounds() const;
+	SpriteAtlas::Sprite sprite;
+	bool burningState;
+};
+
+class houseWithBarrier : public Vehicle {
+public:
+	houseWithBarrier(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
+
+	void setup();
+	void draw();
+	ofRectangle getBounds() const;
+	SpriteAtlas::Sprite sprite;
+};
+
+class Fireman : public Vehicle {
+public:
+	Fireman(std::shared_ptr<KinectProjector> const& k, ofPoint slocation, ofRectangle sborders, ofVec2f motherLocation) : Vehicle(k, slocation, sborders, false, motherLocation) {}
+
+	void setup();
+	void draw();
+	ofRectangle getBounds() const;
+	void moveFireman(int moveDirection);
+	SpriteAtlas::Sprite sprite;	// looking left or right
 };
\ No newline at end of file